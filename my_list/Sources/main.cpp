@@ -3,15 +3,31 @@
 // Author      : Pham Hoang Chi
 // Version     :
 // Copyright   : Copyright from Pham Hoang Chi
-// Description : Test mylist.cpp
+// Description : Test mylist.cpp and mycompactlist.cpp
+//               Runs a random sequence of list operations against a std::list
+//               model and checks size, order, index clamping and list_errno
+//               after every step, then replays the same sequence without the
+//               model to time it. The sequence is run on every list type of
+//               'list_types' through its table of operations. Build with
+//               -fsanitize=address,undefined to run it under ASan/UBSan, or
+//               with -DLIST_FUZZ and -fsanitize=fuzzer to let libFuzzer
+//               generate the sequences.
+//
+//               Build: g++ -O2 main.cpp mylist.cpp mycompactlist.cpp -o my_list
+//               Usage: my_list [seed] [number of operations]
 //============================================================================
 
 #include <iostream>
-#include <check.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include <assert.h>
+#include <list>
+#include <vector>
 #include "mylist.h"
+#include "mycompactlist.h"
 using namespace std;
 
 void element_print(list_elm_pt element);
@@ -21,71 +37,333 @@ int element_compare(list_elm_pt x, list_elm_pt y);
 
 int list_errno;
 
-int main( void )
+/*
+ * One step of a test sequence
+ */
+enum trace_op {
+  OP_INSERT, OP_REMOVE, OP_FREE, OP_GET_ELEMENT, OP_GET_REFERENCE, OP_INDEX_OF, OP_SIZE, OP_NULL_LIST,
+  OP_COUNT
+};
+
+typedef struct trace_step {
+  uint8_t op;
+  int8_t index;  // may be negative or beyond the end of the list to test the clamping
+  int16_t value;
+} trace_step_t;
+
+/*
+ * The operations of one list type used by a test sequence. 'list' is a list_pt or a compact_list_pt.
+ * The functions set list_errno like the list functions they call.
+ */
+typedef struct list_ops {
+  const char *name;
+  void *(*create)( void );
+  void (*destroy)( void **list );
+  void *(*insert)( void *list, list_elm_pt element, int index );   // returns 'list', or NULL on error
+  void *(*remove)( void *list, int index );                        // the element is not returned to the caller
+  void *(*free_at)( void *list, int index );
+  list_elm_pt (*get)( void *list, int index );
+  const void *(*get_reference)( void *list, int index );           // NULL if the type has no node references by index
+  int (*index_of)( void *list, list_elm_pt element );
+  int (*size)( void *list );
+  int (*to_array)( void *list, int *array, int size );             // returns the number of copied elements
+} list_ops_t;
+
+#define CHECK(cond)                                                                   \
+  do {                                                                                \
+    if(!(cond)) {                                                                     \
+      fprintf(stderr, "check '%s' failed at step %d (line %d)\n", #cond, step, __LINE__); \
+      abort();                                                                        \
+    }                                                                                 \
+  } while(0)
+
+static int clamp( int index, int size )
 {
-  list_pt list = NULL;
-  printf("\n=========================================\n");
+  if(index < 0) return 0;
+  if(index >= size) return size-1;
+  return index;
+}
 
-  int* a = (int *)malloc(sizeof(int));
-  *a = 3;
-  int* b = (int *)malloc(sizeof(int));
-  *b = 6;
-  int* c = (int *)malloc(sizeof(int));
-  *c = 9;
-  int* d = (int *)malloc(sizeof(int));
-  *d = 1;
-  int* e = (int *)malloc(sizeof(int));
-  *e = 2;
-
-//  list_insert_at_index(NULL,a,0);
-//  printf("size: %d\n", list_size(list));
-//
-//  list = list_create( &element_copy, &element_free, &element_compare, &element_print);
-//  printf("size: %d\n", list_size(list));
-//  list_print(list);
-//
-//  printf("\n=========================================\n");
-//  list_insert_at_index(list,a,0);
-//
-//  printf("\n=========================================\n");
-//  list_insert_at_index(list,b,0);
-//
-//  printf("\n=========================================\n");
-//  list_insert_at_index(list,c,0);
-//
-//  printf("\n=========================================\n");
-//  list_insert_at_index(list,d,4);
-//
-//  printf("\n=========================================\n");
-//  list_insert_at_index(list,e,2);
-//  printf("size: %d\n", list_size(list));
-//  list_print(list);
-//
-//  element_print(list_get_element_at_index(list, -3));
-//  element_print(list_get_element_at_index(list, 0));
-//  element_print(list_get_element_at_index(list, 1));
-//  element_print(list_get_element_at_index(list, 2));
-//  element_print(list_get_element_at_index(list, 3));
-//  element_print(list_get_element_at_index(list, 4));
-//  element_print(list_get_element_at_index(list, 5));
-//
-//  printf("\n=========================================\n");
-//  list_remove_at_index(list,0);
-//  printf("size: %d\n", list_size(list));
-//  list_print(list);
-//
-//  printf("\n=========================================\n");
-//  list_free_at_index(list,3);
-//  printf("size: %d\n", list_size(list));
-//  list_print(list);
+static std::list<int>::iterator model_at( std::list<int> &model, int index )
+{
+  std::list<int>::iterator it = model.begin();
+  advance(it, index);
+  return it;
+}
+
+/*
+ * mylist operations
+ */
+static void *list_create( void )
+{
+  return mylist_create(&element_copy, &element_free, &element_compare, &element_print);
+}
+
+static void list_destroy( void **list )
+{
+  mylist_free((list_pt *)list);
+}
+
+static void *list_insert( void *list, list_elm_pt element, int index )
+{
+  return mylist_insert_at_index((list_pt)list, element, index);
+}
+
+static void *list_remove( void *list, int index )
+{
+  list_elm_pt element = (mylist_size((list_pt)list) > 0) ? mylist_get_element_at_index((list_pt)list, index) : NULL;
+  list_pt result = mylist_remove_at_index((list_pt)list, index);
+  element_free(&element); // remove doesn't free the element
+  return result;
+}
+
+static void *list_free_at( void *list, int index )
+{
+  return mylist_free_at_index((list_pt)list, index);
+}
+
+static list_elm_pt list_get( void *list, int index )
+{
+  return mylist_get_element_at_index((list_pt)list, index);
+}
+
+static const void *list_get_reference( void *list, int index )
+{
+  return mylist_get_reference_at_index((list_pt)list, index);
+}
+
+static int list_index_of( void *list, list_elm_pt element )
+{
+  return mylist_get_index_of_element((list_pt)list, element);
+}
+
+static int list_size( void *list )
+{
+  return mylist_size((list_pt)list);
+}
+
+static int list_to_array( void *list, int *array, int size )
+{
+  return mylist_to_array((list_pt)list, array, size, sizeof(int));
+}
+
+/*
+ * mycompactlist operations: the elements are stored inline, so remove and free are the same
+ */
+static void *compact_create( void )
+{
+  return mycompactlist_create(sizeof(int), &element_compare, &element_print);
+}
+
+static void compact_destroy( void **list )
+{
+  mycompactlist_free((compact_list_pt *)list);
+}
+
+static void *compact_insert( void *list, list_elm_pt element, int index )
+{
+  return mycompactlist_insert_at_index((compact_list_pt)list, element, index);
+}
+
+static void *compact_remove( void *list, int index )
+{
+  return mycompactlist_remove_at_index((compact_list_pt)list, index);
+}
+
+static list_elm_pt compact_get( void *list, int index )
+{
+  return mycompactlist_get_element_at_index((compact_list_pt)list, index);
+}
+
+static int compact_index_of( void *list, list_elm_pt element )
+{
+  return mycompactlist_get_index_of_element((compact_list_pt)list, element);
+}
+
+static int compact_size( void *list )
+{
+  return mycompactlist_size((compact_list_pt)list);
+}
+
+static int compact_to_array( void *list, int *array, int size )
+{
+  compact_ref_t reference;
+  int n = 0;
+
+  for(reference = mycompactlist_get_first_reference((compact_list_pt)list); reference != COMPACT_NIL && n < size;
+      reference = mycompactlist_get_next_reference((compact_list_pt)list, reference))
+  {
+    array[n++] = *(int *)mycompactlist_get_element_at_reference((compact_list_pt)list, reference);
+  }
+  return n;
+}
+
+static const list_ops_t list_types[] = {
+  { "mylist", list_create, list_destroy, list_insert, list_remove, list_free_at, list_get, list_get_reference,
+    list_index_of, list_size, list_to_array },
+  { "mycompactlist", compact_create, compact_destroy, compact_insert, compact_remove, compact_remove, compact_get, NULL,
+    compact_index_of, compact_size, compact_to_array },
+};
+#define NUM_OF_LIST_TYPES ((int)(sizeof(list_types) / sizeof(list_types[0])))
+
+/*
+ * Runs 'trace' on a new list of type 'ops'. If 'check' is set every step is compared with a std::list model.
+ */
+static void run_trace( const list_ops_t *ops, const trace_step_t *trace, int num_of_step, int check )
+{
+  std::list<int> model;
+  void *list = ops->create();
+  int step, n, index, value;
+
+  for(step = 0; step < num_of_step; step++)
+  {
+    n = check ? (int)model.size() : ops->size(list);
+    index = trace[step].index;
+    value = trace[step].value;
+    switch(trace[step].op % OP_COUNT)
+    {
+      case OP_INSERT:
+        CHECK(ops->insert(list, &value, index) == list);
+        if(check)
+        {
+          CHECK(list_errno == LIST_NO_ERROR);
+          model.insert(model_at(model, (index <= 0) ? 0 : (index > n) ? n : index), value);
+        }
+        break;
+      case OP_REMOVE:
+      case OP_FREE:
+        if(trace[step].op % OP_COUNT == OP_REMOVE) CHECK(ops->remove(list, index) == list);
+        else CHECK(ops->free_at(list, index) == list);
+        if(check)
+        {
+          CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+          if(n > 0) model.erase(model_at(model, clamp(index, n)));
+        }
+        break;
+      case OP_GET_ELEMENT:
+      {
+        list_elm_pt element = ops->get(list, index);
+        if(check)
+        {
+          CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+          if(n == 0) CHECK(element == NULL);
+          else CHECK(*(int *)element == *model_at(model, clamp(index, n)));
+        }
+        break;
+      }
+      case OP_GET_REFERENCE:
+      {
+        if(ops->get_reference == NULL) break;
+        const void *reference = ops->get_reference(list, index);
+        if(check)
+        {
+          CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+          CHECK((reference == NULL) == (n == 0));
+          if(n > 0) CHECK(reference == ops->get_reference(list, clamp(index, n)));
+        }
+        break;
+      }
+      case OP_INDEX_OF:
+      {
+        int found = ops->index_of(list, &value);
+        if(check)
+        {
+          int expected = -1, i = 0;
+          for(std::list<int>::iterator it = model.begin(); it != model.end(); ++it, i++)
+          {
+            if(*it == value) { expected = i; break; }
+          }
+          CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+          CHECK(found == expected);
+        }
+        break;
+      }
+      case OP_SIZE:
+        CHECK(ops->size(list) == n);
+        if(check)
+        {
+          CHECK(list_errno == LIST_NO_ERROR);
+          //compare the order of the whole list
+          vector<int> array(n+1);
+          CHECK(ops->to_array(list, &array[0], n+1) == n);
+          int i = 0;
+          for(std::list<int>::iterator it = model.begin(); it != model.end(); ++it, i++) CHECK(array[i] == *it);
+        }
+        break;
+      case OP_NULL_LIST:
+        if(check)
+        {
+          CHECK(ops->size(NULL) == -1 && list_errno == LIST_INVALID_ERROR);
+          CHECK(ops->insert(NULL, &value, index) == NULL && list_errno == LIST_INVALID_ERROR);
+          CHECK(ops->remove(NULL, index) == NULL && list_errno == LIST_INVALID_ERROR);
+          CHECK(ops->get(NULL, index) == NULL && list_errno == LIST_INVALID_ERROR);
+          CHECK(ops->index_of(list, NULL) == -1 && list_errno == ((n == 0) ? LIST_EMPTY_ERROR : ELEMENT_INVALID_ERROR));
+        }
+        break;
+    }
+  }
+  ops->destroy(&list);
+  if(check)
+  {
+    step = num_of_step;
+    CHECK(list == NULL && list_errno == LIST_NO_ERROR);
+    ops->destroy(&list);
+    CHECK(list_errno == LIST_INVALID_ERROR);
+    ops->destroy(NULL);
+    CHECK(list_errno == LIST_INVALID_ERROR);
+  }
+}
+
+#ifdef LIST_FUZZ
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size )
+{
+  //no whole step: nothing to run ('data' may be NULL when 'size' is 0)
+  if(size < sizeof(trace_step_t)) return 0;
+  vector<trace_step_t> trace(size/sizeof(trace_step_t));
+  memcpy(&trace[0], data, size - size % sizeof(trace_step_t));
+  for(int type = 0; type < NUM_OF_LIST_TYPES; type++) run_trace(&list_types[type], &trace[0], (int)(size/sizeof(trace_step_t)), 1);
+  return 0;
+}
+#else
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_step = (argc > 2) ? atoi(argv[2]) : 100000;
+  vector<trace_step_t> trace(num_of_step > 0 ? num_of_step : 1);
+  int i;
+
+  //random trace: inserts and removes are balanced, so the list keeps growing and shrinking
+  srand(seed);
+  for(i = 0; i < num_of_step; i++)
+  {
+    int r = rand() % 100;
+    trace[i].op = (r < 30) ? OP_INSERT : (r < 45) ? OP_REMOVE : (r < 60) ? OP_FREE : (r < 75) ? OP_GET_ELEMENT :
+                  (r < 85) ? OP_GET_REFERENCE : (r < 93) ? OP_INDEX_OF : (r < 99) ? OP_SIZE : OP_NULL_LIST;
+    trace[i].index = (int8_t)(rand() % 80 - 8);
+    trace[i].value = (int16_t)(rand() % 64);
+  }
+
+  for(int type = 0; type < NUM_OF_LIST_TYPES; type++)
+  {
+    printf("\n=========================================\n");
+    run_trace(&list_types[type], &trace[0], num_of_step, 1);
+    printf("%s, seed %u: %d steps match the std::list model\n", list_types[type].name, seed, num_of_step);
+
+    clock_t start = clock();
+    run_trace(&list_types[type], &trace[0], num_of_step, 0);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("replay without checks: %.3f s, %.1f Mops/s\n", seconds, (seconds > 0) ? num_of_step / seconds / 1e6 : 0.0);
+  }
 
   #ifdef LIST_EXTRA
+  int values[] = { 3, 6, 9, 1, 2 };
+  list_pt list = mylist_create_from_array(values, 5, sizeof(int), &element_copy, &element_free, &element_compare, &element_print);
   printf("\n=========================================\n");
   element_print(list_get_element_at_reference(list, list_get_first_reference(list))); //print first element
   element_print(list_get_element_at_reference(list, list_get_last_reference(list)));  //print last element
 
   printf("\n=========================================\n");
-  list_node_ptr_t temp = list_get_next_reference(list, list_get_first_reference(list)); //get 2nd node
+  list_node_pt temp = list_get_next_reference(list, list_get_first_reference(list)); //get 2nd node
   printf("index = %d\n", list_get_index_of_reference(list, temp));
   element_print(list_get_element_at_reference(list, temp));							//print next element of 2nd node
 
@@ -93,30 +371,24 @@ int main( void )
   temp = list_get_next_reference(list, temp); //get 3rd node
   printf("index = %d\n", list_get_index_of_reference(list, temp));
   element_print(list_get_element_at_reference(list, temp)); //print next element of 3rd node
-  //element_print(list_get_element_at_reference(list, list_get_previous_reference(list, temp))); //print 2nd node
 
-  list_remove_at_reference(list, temp);
-  list_print(list);
+  list_free_at_reference(list, temp);
+  mylist_print(list);
+  mylist_free(&list);
   #endif
 
-//  list_free(&list);
-
-  free(a);
-  free(b);
-  free(c);
-  free(d);
-  free(e);
-
   return 0;
 }
+#endif
 
 /*
  * Copy the 'content' of src_element to dst_element.
  */
 void element_copy(list_elm_pt *dest_element, list_elm_pt src_element)
 {
-  //...
-  //*dest_element = src_element; // ok if element_t is int
+  int *copy = (int *)malloc(sizeof(int)); // deep copy if element_t is int
+  if(copy != NULL) *copy = *(int *)src_element;
+  *dest_element = copy;
 }
 
 
@@ -125,8 +397,8 @@ void element_copy(list_elm_pt *dest_element, list_elm_pt src_element)
  */
 void element_free(list_elm_pt *element)
 {
-  // ...
-  // nothing to do if element_t is int
+  free(*element);
+  *element = NULL;
 }
 
 /*
@@ -142,8 +414,8 @@ void element_print(list_elm_pt element)
  */
 int element_compare(list_elm_pt x, list_elm_pt y)
 {
-  // ...
-  if(*(int *)x == *(int *)y) { return 1; }
-  else { return 0;}
+  if(*(int *)x < *(int *)y) { return -1; }
+  if(*(int *)x > *(int *)y) { return 1; }
+  return 0;
 
 }
@@ -0,0 +1,607 @@
+/*
+ ============================================================================
+ Name        : mycompactlist.cpp
+ Author      : cph
+ Version     : 1.0
+ Copyright   : Copyright from Chi Pham Hoang
+ Description : Implementation of a double-linked list stored in one array
+ 	 	 	   Dynamic memory
+ Note 	     : 1) Links are 32-bit indices into the node array, elements
+ 	 	 	   are stored inline in their node.
+ 	 	 	   2) Removed nodes are chained in a free list and reused.
+ 	 	 	   3) A saved image is checked before use: header fields,
+ 	 	 	   links and the free chain must all stay inside the array.
+			   4) User must implement 2 functions to work with this API:
+			   - A compare function; to compare 2 elements in the list
+			   - A print function: to print out an element to stdout
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mycompactlist.h"
+
+#ifdef DEBUG
+	#define DEBUG_PRINT(...) 															\
+	  do {					  															\
+		printf("In %s - function %s at line %d: ", __FILE__, __func__, __LINE__);		\
+		printf(__VA_ARGS__);															\
+	  } while(0)
+#else
+	#define DEBUG_PRINT(...) (void)0
+#endif
+
+#define COMPACT_MAGIC 0x54534C43u // "CLST"
+#define COMPACT_INITIAL_CAPACITY 16
+#define COMPACT_MAX_ELEMENT_SIZE (1 << 24)
+
+/*
+ * The real definition of 'struct compact_list'
+ */
+typedef struct compact_node {
+	uint32_t prev;
+	uint32_t next;
+	// followed by 'element_size' bytes of element
+} compact_node_t;
+
+typedef struct compact_header {
+	uint32_t magic;
+	uint32_t element_size;
+	uint32_t node_size;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t free_head; // first removed node, chained by 'next'
+	uint32_t num_of_element;
+	uint32_t used;      // nodes of the array that were ever used
+} compact_header_t;
+
+struct compact_list {
+	compact_header_t hdr; // everything that is saved with the node array
+	uint32_t capacity;
+	unsigned char *nodes;
+	int attached;         // 'nodes' is a caller buffer (mycompactlist_attach): copied before it grows, never freed
+	element_compare_func *element_compare; //callback function
+	element_print_func *element_print;
+};
+
+#define COMPACT_NODE(list, ref) ((compact_node_t *)((list)->nodes + (size_t)(ref)*(list)->hdr.node_size))
+#define COMPACT_ELEMENT(list, ref) ((list_elm_pt)((list)->nodes + (size_t)(ref)*(list)->hdr.node_size + sizeof(compact_node_t)))
+
+/*
+ * Private functions
+ */
+static uint32_t compact_node_size( uint32_t element_size )
+{
+	uint32_t align = (element_size % 8 == 0) ? 8 : 4; // keep 8-byte elements aligned
+	return (sizeof(compact_node_t) + element_size + align-1) & ~(align-1);
+}
+// Returns the size of a node holding an element of 'element_size' bytes.
+
+static int compact_header_is_valid( const compact_header_t *hdr )
+{
+	if(hdr->magic != COMPACT_MAGIC) return 0;
+	if(hdr->element_size == 0 || hdr->element_size > COMPACT_MAX_ELEMENT_SIZE) return 0;
+	if(hdr->node_size != compact_node_size(hdr->element_size)) return 0;
+	if(hdr->used >= COMPACT_NIL || hdr->num_of_element > hdr->used) return 0;
+	if(hdr->head != COMPACT_NIL && hdr->head >= hdr->used) return 0;
+	if(hdr->tail != COMPACT_NIL && hdr->tail >= hdr->used) return 0;
+	if(hdr->free_head != COMPACT_NIL && hdr->free_head >= hdr->used) return 0;
+	if((hdr->head == COMPACT_NIL) != (hdr->num_of_element == 0) || (hdr->tail == COMPACT_NIL) != (hdr->num_of_element == 0)) return 0;
+	return 1;
+}
+// Returns 1 if the fields of a loaded header are consistent, 0 otherwise.
+
+static int compact_nodes_are_valid( compact_list_pt list )
+{
+	compact_ref_t ref, prev = COMPACT_NIL;
+	unsigned char *seen;
+	uint32_t i;
+	int valid = 1;
+
+	seen = (unsigned char *)calloc(list->hdr.used/8 + 1, 1);
+	if(seen == NULL) return -1;
+	//the element chain: 'num_of_element' nodes from head to tail, with matching prev links
+	ref = list->hdr.head;
+	for(i = 0; valid && i < list->hdr.num_of_element; i++)
+	{
+		if(ref >= list->hdr.used || (seen[ref/8] & (1 << ref%8)) || COMPACT_NODE(list, ref)->prev != prev)
+		{
+			valid = 0;
+			break;
+		}
+		seen[ref/8] |= 1 << ref%8;
+		prev = ref;
+		ref = COMPACT_NODE(list, ref)->next;
+	}
+	if(ref != COMPACT_NIL || prev != list->hdr.tail) valid = 0;
+	//the free chain: at most the other nodes, none of them linked
+	ref = list->hdr.free_head;
+	for(i = list->hdr.num_of_element; valid && ref != COMPACT_NIL; i++)
+	{
+		if(i >= list->hdr.used || ref >= list->hdr.used || (seen[ref/8] & (1 << ref%8)))
+		{
+			valid = 0;
+			break;
+		}
+		seen[ref/8] |= 1 << ref%8;
+		ref = COMPACT_NODE(list, ref)->next;
+	}
+	free(seen);
+	return valid;
+}
+// Returns 1 if all links of the node array of 'list' stay inside the array and no node is reached twice, 0 if not,
+// -1 if memory allocation failed. The header must be valid.
+
+static compact_ref_t compact_node_at( compact_list_pt list, int index )
+{
+	int i;
+	compact_ref_t ref;
+	if(index > (int)list->hdr.num_of_element/2)
+	{
+		ref = list->hdr.tail; //walk back from the end of 'list'
+		for(i = list->hdr.num_of_element-1; i > index; i--) ref = COMPACT_NODE(list, ref)->prev;
+		return ref;
+	}
+	ref = list->hdr.head;
+	for(i = 0; i < index; i++) ref = COMPACT_NODE(list, ref)->next;
+	return ref;
+}
+// Walks to the node at position 'index' from the nearest end. 'list' must not be empty and 'index' must already be clamped.
+
+static compact_ref_t compact_node_alloc( compact_list_pt list )
+{
+	compact_ref_t ref = list->hdr.free_head;
+	unsigned char *nodes;
+	uint32_t capacity;
+
+	if(ref != COMPACT_NIL)
+	{
+		list->hdr.free_head = COMPACT_NODE(list, ref)->next;
+		return ref;
+	}
+	if(list->hdr.used == list->capacity)
+	{
+		if(list->capacity >= COMPACT_NIL/2) return COMPACT_NIL;
+		capacity = (list->capacity == 0) ? COMPACT_INITIAL_CAPACITY : list->capacity*2;
+		if(list->attached)
+		{
+			//the caller buffer can't grow: move to an own array
+			nodes = (unsigned char *)malloc((size_t)capacity*list->hdr.node_size);
+			if(nodes == NULL) return COMPACT_NIL;
+			memcpy(nodes, list->nodes, (size_t)list->hdr.used*list->hdr.node_size);
+			list->attached = 0;
+		}
+		else nodes = (unsigned char *)realloc(list->nodes, (size_t)capacity*list->hdr.node_size);
+		if(nodes == NULL) return COMPACT_NIL;
+		list->nodes = nodes;
+		list->capacity = capacity;
+	}
+	return list->hdr.used++;
+}
+// Returns a removed node if there is one, otherwise the next unused node of the array (which is grown if needed).
+// Returns COMPACT_NIL if memory allocation failed.
+
+/*
+ * Public functions
+ */
+compact_list_pt mycompactlist_create( int element_size, element_compare_func *element_compare, element_print_func *element_print )
+{
+	compact_list_pt list;
+
+	list_errno = LIST_NO_ERROR;
+	//Check the element size
+	if(element_size <= 0 || element_size > COMPACT_MAX_ELEMENT_SIZE)
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid element size\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	list = (compact_list_pt) malloc(sizeof(compact_list_t));
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in list allocating\n" );
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	list->hdr.magic = COMPACT_MAGIC;
+	list->hdr.element_size = element_size;
+	list->hdr.node_size = compact_node_size(element_size);
+	list->hdr.head = COMPACT_NIL;
+	list->hdr.tail = COMPACT_NIL;
+	list->hdr.free_head = COMPACT_NIL;
+	list->hdr.num_of_element = 0;
+	list->hdr.used = 0;
+	list->capacity = 0;
+	list->nodes = NULL;
+	list->attached = 0;
+	list->element_compare = element_compare;
+	list->element_print = element_print;
+	return list;
+}
+// Returns a pointer to a newly-allocated list for elements of 'element_size' bytes.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR,
+// or if 'element_size' is 0, negative or bigger than 16 MB and list_errno is set to LIST_INVALID_ERROR
+
+void mycompactlist_free( compact_list_pt *list )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL || *list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	if(!(*list)->attached) free((*list)->nodes);
+	free(*list);
+	*list = NULL;
+}
+// The node array and the list itself are deleted (free memory) and the list is set to NULL
+
+int mycompactlist_size_r( compact_list_pt list, int *size )
+{
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG::List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	*size = list->hdr.num_of_element;
+	return LIST_NO_ERROR;
+}
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mycompactlist_size( compact_list_pt list )
+{
+	int size = -1;
+	list_errno = mycompactlist_size_r(list, &size);
+	return size;
+}
+// Returns the number of elements in 'list'.
+
+compact_list_pt mycompactlist_insert_at_index( compact_list_pt list, list_elm_pt element, int index )
+{
+	compact_ref_t ref, prev;
+	compact_node_t *node;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	ref = compact_node_alloc(list);
+	if(ref == COMPACT_NIL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in allocating a new compact_node\n" );
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	memcpy(COMPACT_ELEMENT(list, ref), element, list->hdr.element_size);
+	node = COMPACT_NODE(list, ref);
+
+	//the node is inserted at the start of 'list'
+	if(index <= 0 || list->hdr.num_of_element == 0)
+	{
+		node->prev = COMPACT_NIL;
+		node->next = list->hdr.head;
+		if(list->hdr.head != COMPACT_NIL) COMPACT_NODE(list, list->hdr.head)->prev = ref;
+		else list->hdr.tail = ref;
+		list->hdr.head = ref;
+	}
+	else
+	{
+		//the node is inserted after the node at 'index'-1, or at the end of 'list'
+		if(index > (int)list->hdr.num_of_element) index = list->hdr.num_of_element;
+		prev = compact_node_at(list, index-1);
+		node->prev = prev;
+		node->next = COMPACT_NODE(list, prev)->next;
+		if(node->next != COMPACT_NIL) COMPACT_NODE(list, node->next)->prev = ref;
+		else list->hdr.tail = ref;
+		COMPACT_NODE(list, prev)->next = ref;
+	}
+	list->hdr.num_of_element++;
+	return list;
+}
+// Inserts a copy of the 'element_size' bytes at 'element' in 'list' at position 'index' and returns 'list'.
+// If 'index' is 0 or negative, the element is inserted at the start of 'list'.
+// If 'index' is bigger than the number of elements in 'list', the element is inserted at the end of 'list'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+compact_list_pt mycompactlist_remove_at_index( compact_list_pt list, int index )
+{
+	compact_ref_t ref;
+	compact_node_t *node;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	//Check the list is empty
+	if(list->hdr.num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return list;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (int)list->hdr.num_of_element) index = list->hdr.num_of_element-1;
+
+	ref = compact_node_at(list, index);
+	node = COMPACT_NODE(list, ref);
+	if(node->prev == COMPACT_NIL) list->hdr.head = node->next;
+	else COMPACT_NODE(list, node->prev)->next = node->next;
+	if(node->next == COMPACT_NIL) list->hdr.tail = node->prev;
+	else COMPACT_NODE(list, node->next)->prev = node->prev;
+	node->next = list->hdr.free_head;
+	list->hdr.free_head = ref;
+	list->hdr.num_of_element--;
+	return list;
+}
+// Removes the element at index 'index' from 'list'. Its node is reused by a next insert.
+// If 'index' is 0 or negative, the first element is removed.
+// If 'index' is bigger than the number of elements in 'list', the last element is removed.
+// If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
+
+int mycompactlist_get_element_at_index_r( compact_list_pt list, int index, list_elm_pt *element )
+{
+	*element = NULL;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->hdr.num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (int)list->hdr.num_of_element) index = list->hdr.num_of_element-1;
+	*element = COMPACT_ELEMENT(list, compact_node_at(list, index));
+	return LIST_NO_ERROR;
+}
+// Stores a pointer to the element with index 'index' inside the node array in '*element' (same clamping as mycompactlist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+list_elm_pt mycompactlist_get_element_at_index( compact_list_pt list, int index )
+{
+	list_elm_pt element;
+	list_errno = mycompactlist_get_element_at_index_r(list, index, &element);
+	return element;
+}
+// Returns a pointer to the element with index 'index' inside the node array. It is valid until the next insert.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'list', the last element is returned.
+// If the list is empty, NULL is returned.
+
+int mycompactlist_get_index_of_element_r( compact_list_pt list, list_elm_pt element, int *index )
+{
+	int i = 0;
+	compact_ref_t ref;
+
+	*index = -1;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->hdr.num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check the element is NULL
+	if(element == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Input element is NULL\n" );
+		return ELEMENT_INVALID_ERROR;
+	}
+	for(ref = list->hdr.head; ref != COMPACT_NIL; ref = COMPACT_NODE(list, ref)->next)
+	{
+		if(list->element_compare(COMPACT_ELEMENT(list, ref), element) == 0)
+		{
+			*index = i;
+			break;
+		}
+		i++;
+	}
+	// If 'element' is not found in 'list', -1 is stored
+	return LIST_NO_ERROR;
+}
+// Stores the index of the first element in 'list' that compares equal to 'element' in '*index', or -1 if it is not found.
+// Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mycompactlist_get_index_of_element( compact_list_pt list, list_elm_pt element )
+{
+	int index;
+	list_errno = mycompactlist_get_index_of_element_r(list, element, &index);
+	return index;
+}
+// Returns an index to the first element in 'list' that compares equal to 'element'.
+// If 'element' is not found in 'list', -1 is returned.
+
+compact_ref_t mycompactlist_get_first_reference( compact_list_pt list )
+{
+	if(list == NULL) return COMPACT_NIL;
+	return list->hdr.head;
+}
+// Returns a reference to the first node of 'list', or COMPACT_NIL if the list is empty.
+
+compact_ref_t mycompactlist_get_next_reference( compact_list_pt list, compact_ref_t reference )
+{
+	if(list == NULL || reference == COMPACT_NIL) return COMPACT_NIL;
+	return COMPACT_NODE(list, reference)->next;
+}
+// Returns a reference to the next node, or COMPACT_NIL at the end.
+
+list_elm_pt mycompactlist_get_element_at_reference( compact_list_pt list, compact_ref_t reference )
+{
+	if(list == NULL || reference == COMPACT_NIL) return NULL;
+	return COMPACT_ELEMENT(list, reference);
+}
+// Returns a pointer to the element of node 'reference', or NULL if 'reference' is COMPACT_NIL.
+
+compact_list_pt mycompactlist_save( compact_list_pt list, FILE *fp )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL || fp == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	if(fwrite(&(list->hdr), sizeof(compact_header_t), 1, fp) != 1 ||
+	   (list->hdr.used > 0 && fwrite(list->nodes, list->hdr.node_size, list->hdr.used, fp) != list->hdr.used))
+	{
+		DEBUG_PRINT( "DEBUG:: Error in writing the list\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	return list;
+}
+// Writes 'list' (header and node array) to 'fp' in binary form and returns 'list'.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if 'list' is NULL or writing failed.
+
+compact_list_pt mycompactlist_load( FILE *fp, element_compare_func *element_compare, element_print_func *element_print )
+{
+	compact_header_t hdr;
+	compact_list_pt list;
+	unsigned char *nodes;
+	uint32_t num_of_read, capacity;
+	int valid;
+
+	list_errno = LIST_NO_ERROR;
+	if(fp == NULL || fread(&hdr, sizeof(compact_header_t), 1, fp) != 1 || !compact_header_is_valid(&hdr))
+	{
+		DEBUG_PRINT( "DEBUG:: Error in reading the list\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	list = mycompactlist_create(hdr.element_size, element_compare, element_print);
+	if(list == NULL) return NULL;
+	//the array grows while it is read, so a wrong 'used' in a short file can't make a huge allocation
+	for(num_of_read = 0; num_of_read < hdr.used; num_of_read = capacity)
+	{
+		capacity = (num_of_read < COMPACT_INITIAL_CAPACITY) ? COMPACT_INITIAL_CAPACITY : (num_of_read > hdr.used/2) ? hdr.used : num_of_read*2;
+		if(capacity > hdr.used) capacity = hdr.used;
+		nodes = (unsigned char *)realloc(list->nodes, (size_t)capacity*hdr.node_size);
+		if(nodes == NULL)
+		{
+			DEBUG_PRINT( "DEBUG:: Error in allocating the node array\n" );
+			mycompactlist_free(&list);
+			list_errno = LIST_MEMORY_ERROR;
+			return NULL;
+		}
+		list->nodes = nodes;
+		if(fread(list->nodes + (size_t)num_of_read*hdr.node_size, hdr.node_size, capacity - num_of_read, fp) != capacity - num_of_read)
+		{
+			DEBUG_PRINT( "DEBUG:: Error in reading the list\n" );
+			mycompactlist_free(&list);
+			list_errno = LIST_INVALID_ERROR;
+			return NULL;
+		}
+	}
+	list->hdr = hdr;
+	list->capacity = hdr.used;
+	valid = compact_nodes_are_valid(list);
+	if(valid != 1)
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid node array\n" );
+		mycompactlist_free(&list);
+		list_errno = (valid < 0) ? LIST_MEMORY_ERROR : LIST_INVALID_ERROR;
+		return NULL;
+	}
+	return list;
+}
+// Returns a newly-allocated list read from 'fp' (written by mycompactlist_save on the same platform).
+// The header and all links are checked before the list is returned.
+// Returns NULL and list_errno is set to LIST_MEMORY_ERROR or LIST_INVALID_ERROR if allocation or reading failed
+// or the data is not a valid list.
+
+compact_list_pt mycompactlist_attach( void *image, size_t size, element_compare_func *element_compare, element_print_func *element_print )
+{
+	compact_header_t hdr;
+	compact_list_pt list;
+	int valid;
+
+	list_errno = LIST_NO_ERROR;
+	//Check the image: a valid header followed by the whole node array
+	if(image == NULL || ((uintptr_t)image % 8) != 0 || size < sizeof(compact_header_t))
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid image\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	memcpy(&hdr, image, sizeof(compact_header_t));
+	if(!compact_header_is_valid(&hdr) || (size - sizeof(compact_header_t))/hdr.node_size < hdr.used)
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid image\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	list = mycompactlist_create(hdr.element_size, element_compare, element_print);
+	if(list == NULL) return NULL;
+	list->hdr = hdr;
+	list->nodes = (unsigned char *)image + sizeof(compact_header_t);
+	list->capacity = hdr.used;
+	list->attached = 1;
+	valid = compact_nodes_are_valid(list);
+	if(valid != 1)
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid node array\n" );
+		mycompactlist_free(&list);
+		list_errno = (valid < 0) ? LIST_MEMORY_ERROR : LIST_INVALID_ERROR;
+		return NULL;
+	}
+	return list;
+}
+// Returns a newly-allocated list that uses the node array inside 'image' (the 'size' bytes written by
+// mycompactlist_save, e.g. mmap'ed from the file) in place, without copying it.
+// The header and all links are checked first. Removes and inserts that reuse a removed node write to 'image';
+// an insert that needs a bigger array first copies the nodes to an own array. 'image' is not freed by mycompactlist_free
+// and must stay valid (and writable if the list is changed) until then. The header inside 'image' is not updated.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if 'image' is NULL, not 8-byte aligned or not a valid list,
+// or to LIST_MEMORY_ERROR if memory allocation failed.
+
+void mycompactlist_print( compact_list_pt list )
+{
+	compact_ref_t ref;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	//Check the list is empty
+	if(list->hdr.num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return;
+	}
+	for(ref = list->hdr.head; ref != COMPACT_NIL; ref = COMPACT_NODE(list, ref)->next)
+	{
+		list->element_print(COMPACT_ELEMENT(list, ref));
+	}
+}
+// for testing purposes: print the entire list on screen
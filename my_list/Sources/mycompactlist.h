@@ -0,0 +1,107 @@
+#ifndef MYCOMPACTLIST_H_
+#define MYCOMPACTLIST_H_
+
+#include <stdio.h>
+#include "mylist.h"
+
+/*
+ * Compact list: a double-linked list whose nodes live in one growable array.
+ * prev/next are 32-bit array indices instead of pointers and every element of 'element_size' bytes
+ * is stored inline in its node (copied with memcpy, no element_copy/element_free callbacks).
+ * A node of an 8-byte element takes 16 bytes, against 24 bytes plus malloc overhead plus the element for mylist.
+ * The array holds no pointers, so it can be written to a file and loaded again, or the file can be mmap'ed
+ * and used in place with mycompactlist_attach.
+ * Index semantics (clamping of 'index') are the same as for mylist; errors are reported through list_errno.
+ * The read-only queries also have status returning _r forms that leave list_errno alone (see below).
+ */
+
+typedef unsigned int compact_ref_t; // index of a node in the node array
+#define COMPACT_NIL 0xFFFFFFFFu      // 'no node' reference
+
+typedef struct compact_list compact_list_t;
+typedef compact_list_t *compact_list_pt;
+
+compact_list_pt mycompactlist_create( int element_size, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a pointer to a newly-allocated list for elements of 'element_size' bytes.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR,
+// or if 'element_size' is 0, negative or bigger than 16 MB and list_errno is set to LIST_INVALID_ERROR
+
+void mycompactlist_free( compact_list_pt *list );
+// The node array and the list itself are deleted (free memory) and the list is set to NULL
+
+int mycompactlist_size( compact_list_pt list );
+// Returns the number of elements in 'list'.
+
+compact_list_pt mycompactlist_insert_at_index( compact_list_pt list, list_elm_pt element, int index );
+// Inserts a copy of the 'element_size' bytes at 'element' in 'list' at position 'index' and returns 'list'.
+// If 'index' is 0 or negative, the element is inserted at the start of 'list'.
+// If 'index' is bigger than the number of elements in 'list', the element is inserted at the end of 'list'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+compact_list_pt mycompactlist_remove_at_index( compact_list_pt list, int index );
+// Removes the element at index 'index' from 'list'. Its node is reused by a next insert.
+// If 'index' is 0 or negative, the first element is removed.
+// If 'index' is bigger than the number of elements in 'list', the last element is removed.
+// If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
+
+list_elm_pt mycompactlist_get_element_at_index( compact_list_pt list, int index );
+// Returns a pointer to the element with index 'index' inside the node array. It is valid until the next insert.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'list', the last element is returned.
+// If the list is empty, NULL is returned.
+
+int mycompactlist_get_index_of_element( compact_list_pt list, list_elm_pt element );
+// Returns an index to the first element in 'list' that compares equal to 'element'.
+// If 'element' is not found in 'list', -1 is returned.
+
+compact_ref_t mycompactlist_get_first_reference( compact_list_pt list );
+// Returns a reference to the first node of 'list', or COMPACT_NIL if the list is empty.
+
+compact_ref_t mycompactlist_get_next_reference( compact_list_pt list, compact_ref_t reference );
+// Returns a reference to the next node, or COMPACT_NIL at the end.
+
+list_elm_pt mycompactlist_get_element_at_reference( compact_list_pt list, compact_ref_t reference );
+// Returns a pointer to the element of node 'reference', or NULL if 'reference' is COMPACT_NIL.
+
+compact_list_pt mycompactlist_save( compact_list_pt list, FILE *fp );
+// Writes 'list' (header and node array) to 'fp' in binary form and returns 'list'.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if 'list' is NULL or writing failed.
+
+compact_list_pt mycompactlist_load( FILE *fp, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a newly-allocated list read from 'fp' (written by mycompactlist_save on the same platform).
+// The header and all links are checked before the list is returned.
+// Returns NULL and list_errno is set to LIST_MEMORY_ERROR or LIST_INVALID_ERROR if allocation or reading failed
+// or the data is not a valid list.
+
+compact_list_pt mycompactlist_attach( void *image, size_t size, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a newly-allocated list that uses the node array inside 'image' (the 'size' bytes written by
+// mycompactlist_save, e.g. mmap'ed from the file) in place, without copying it.
+// The header and all links are checked first. Removes and inserts that reuse a removed node write to 'image';
+// an insert that needs a bigger array first copies the nodes to an own array. 'image' is not freed by mycompactlist_free
+// and must stay valid (and writable if the list is changed) until then. The header inside 'image' is not updated.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if 'image' is NULL, not 8-byte aligned or not a valid list,
+// or to LIST_MEMORY_ERROR if memory allocation failed.
+
+/*
+ * Status returning API
+ * Like the mylist_*_r functions, these return LIST_NO_ERROR or an error code, pass the result back through
+ * the last argument and never write list_errno, so several threads can read the same list concurrently.
+ * The queries above are wrappers around these that copy the returned code into list_errno.
+ */
+
+int mycompactlist_size_r( compact_list_pt list, int *size );
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mycompactlist_get_element_at_index_r( compact_list_pt list, int index, list_elm_pt *element );
+// Stores a pointer to the element with index 'index' inside the node array in '*element' (same clamping as mycompactlist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+int mycompactlist_get_index_of_element_r( compact_list_pt list, list_elm_pt element, int *index );
+// Stores the index of the first element in 'list' that compares equal to 'element' in '*index', or -1 if it is not found.
+// Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+void mycompactlist_print( compact_list_pt list );
+// for testing purposes: print the entire list on screen
+
+#endif  //MYCOMPACTLIST_H_
@@ -18,8 +18,22 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 //#include <assert.h>
 #include "mylist.h"
+#if defined(LIST_PARALLEL) || defined(LIST_NODE_CACHE)
+	#include <pthread.h>
+#endif
+#ifdef LIST_PARALLEL
+	#include <unistd.h>
+#endif
+#ifdef LIST_TRACE
+	#include <time.h>
+	#ifdef LIST_TRACE_TSC
+		#include <x86intrin.h>
+	#endif
+#endif
 
 #ifdef DEBUG
 	#define DEBUG_PRINT(...) 															\
@@ -31,6 +45,18 @@
 	#define DEBUG_PRINT(...) (void)0
 #endif
 
+#ifndef LIST_PARALLEL_MIN
+	#define LIST_PARALLEL_MIN 65536 // lists shorter than this are exported and sorted by a single thread
+#endif
+
+#ifndef LIST_NODE_CACHE_MAGAZINE
+	#define LIST_NODE_CACHE_MAGAZINE 64 // default number of free nodes cached per thread
+#endif
+
+#ifndef LIST_NODE_CACHE_DEPOT
+	#define LIST_NODE_CACHE_DEPOT 64 // default number of batches kept in the shared depot
+#endif
+
 
 /*
  * The real definition of 'struct list'
@@ -41,15 +67,40 @@ struct list_node {
 	list_elm_pt element;
 };
 
+typedef struct list_node_block list_node_block_t;
+struct list_node_block {
+	list_node_block_t *next;
+	int num_of_node;
+	list_node_t node[1]; // 'num_of_node' nodes are allocated in one block
+};
+
 struct list {
 	list_node_pt head;
+	list_node_pt tail;
 	int num_of_element;
+	list_node_block_t *blocks; // node blocks from mylist_create_from_array, freed with the list
+	list_node_pt spare; // released nodes of a list that has blocks, chained by 'next', reused by the next inserts
 	element_copy_func *element_copy; //callback function
 	element_free_func *element_free;
 	element_compare_func *element_compare;
 	element_print_func *element_print; 
+	element_hash_func *element_hash; // optional, used by the set operations
+	int num_of_tombstone; // removed nodes that are still linked, not counted in 'num_of_element'
+	double max_tombstone_ratio; // lazy removal: compact when tombstones exceed this part of all nodes, 0 for off
 }; 
 
+/*
+ * Lazy removal: a removed node stays linked with its element pointer set to the address of 'list_tombstone_mark'.
+ * Every walk skips such nodes and index positions count only the other ones.
+ */
+static char list_tombstone_mark;
+#define LIST_IS_TOMBSTONE(node) ((node)->element == (list_elm_pt)&list_tombstone_mark)
+
+/*
+ * mylist_free marks the nodes of the node blocks with the address of 'list_block_mark' to tell them from single nodes.
+ */
+static char list_block_mark;
+
 void mem_alloc_check(void *p, char *msg) {
 	if(p == NULL) {
 		fprintf(stderr, "\n%s: memory allocation error\n", msg);
@@ -57,392 +108,1919 @@ void mem_alloc_check(void *p, char *msg) {
 	}
 }
 
+#ifdef LIST_NODE_CACHE
 /*
- * Public functions
- */ 
-list_pt mylist_create(element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print){
-	list_pt mylist=NULL;	
-	list_errno = LIST_NO_ERROR;
-	mylist = (list_pt) malloc(sizeof(list_t)); // list allocated
+ * Per-thread node cache
+ * Every thread keeps a magazine of freed list nodes. A full magazine gives half of its nodes as one batch
+ * to the shared depot, an empty magazine takes a batch back before falling back to malloc().
+ * Only the depot is protected by a lock. A batch is chained by 'next', its first node stores the
+ * batch size in 'element' and the next batch of the depot in 'prev'.
+ */
+static int node_cache_magazine_size = LIST_NODE_CACHE_MAGAZINE;
+static int node_cache_depot_size = LIST_NODE_CACHE_DEPOT;
+static pthread_mutex_t node_cache_depot_lock = PTHREAD_MUTEX_INITIALIZER;
+static list_node_pt node_cache_depot = NULL;
+static int node_cache_depot_count = 0;
+static list_node_cache_stats_t node_cache_exited_stats; // stats of the threads that already exited
+
+static void node_cache_stats_add( list_node_cache_stats_t *total, const list_node_cache_stats_t *stats )
+{
+	total->alloc_count += stats->alloc_count;
+	total->hit_count += stats->hit_count;
+	total->release_count += stats->release_count;
+	total->depot_get_count += stats->depot_get_count;
+	total->depot_put_count += stats->depot_put_count;
+	total->free_count += stats->free_count;
+}
+
+typedef struct node_magazine {
+	list_node_pt top;
+	int num_of_node;
+	list_node_cache_stats_t stats;
+	~node_magazine(); // gives the cached nodes to the depot when the thread exits
+} node_magazine_t;
+
+static thread_local node_magazine_t node_cache_magazine;
+
+static void node_cache_put_batch( list_node_pt batch, int num_of_node )
+{
+	node_magazine_t *magazine = &node_cache_magazine;
+	list_node_pt next;
+
+	pthread_mutex_lock(&node_cache_depot_lock);
+	if(node_cache_depot_count < node_cache_depot_size)
+	{
+		batch->element = (list_elm_pt)(intptr_t)num_of_node;
+		batch->prev = node_cache_depot;
+		__atomic_store_n(&node_cache_depot, batch, __ATOMIC_RELAXED);
+		node_cache_depot_count++;
+		pthread_mutex_unlock(&node_cache_depot_lock);
+		magazine->stats.depot_put_count++;
+		return;
+	}
+	pthread_mutex_unlock(&node_cache_depot_lock);
+	//the depot is full: give the memory back
+	while(batch != NULL)
+	{
+		next = batch->next;
+		free(batch);
+		magazine->stats.free_count++;
+		batch = next;
+	}
+}
+
+node_magazine::~node_magazine()
+{
+	if(top != NULL) node_cache_put_batch(top, num_of_node);
+	top = NULL;
+	num_of_node = 0;
+	pthread_mutex_lock(&node_cache_depot_lock);
+	node_cache_stats_add(&node_cache_exited_stats, &stats);
+	pthread_mutex_unlock(&node_cache_depot_lock);
+}
+
+static list_node_pt node_cache_get( void )
+{
+	node_magazine_t *magazine = &node_cache_magazine;
+	list_node_pt node;
+
+	magazine->stats.alloc_count++;
+	if(magazine->num_of_node == 0 && __atomic_load_n(&node_cache_depot, __ATOMIC_RELAXED) != NULL) // peek without the lock, checked again under it
+	{
+		pthread_mutex_lock(&node_cache_depot_lock);
+		node = node_cache_depot;
+		if(node != NULL)
+		{
+			__atomic_store_n(&node_cache_depot, node->prev, __ATOMIC_RELAXED);
+			node_cache_depot_count--;
+			magazine->top = node;
+			magazine->num_of_node = (int)(intptr_t)node->element;
+			magazine->stats.depot_get_count++;
+		}
+		pthread_mutex_unlock(&node_cache_depot_lock);
+	}
+	node = magazine->top;
+	if(node == NULL) return (list_node_pt)malloc(sizeof(list_node_t));
+	magazine->top = node->next;
+	magazine->num_of_node--;
+	magazine->stats.hit_count++;
+	return node;
+}
+// Returns a node of the calling thread's magazine (or of a depot batch), a newly-allocated node otherwise.
+
+static void node_cache_put( list_node_pt node )
+{
+	node_magazine_t *magazine = &node_cache_magazine;
+	list_node_pt batch, last;
+	int i, batch_size;
+
+	magazine->stats.release_count++;
+	if(magazine->num_of_node >= node_cache_magazine_size)
+	{
+		//the magazine is full: move half of it to the depot in one batch
+		batch_size = node_cache_magazine_size/2;
+		if(batch_size < 1) batch_size = 1;
+		batch = magazine->top;
+		last = batch;
+		for(i=1; i < batch_size; i++) last = last->next;
+		magazine->top = last->next;
+		magazine->num_of_node -= batch_size;
+		last->next = NULL;
+		node_cache_put_batch(batch, batch_size);
+	}
+	node->next = magazine->top;
+	magazine->top = node;
+	magazine->num_of_node++;
+}
+// Gives 'node' to the calling thread's magazine.
+#endif
+
+#ifdef LIST_TRACE
+/*
+ * Trace hooks
+ * A list_trace_scope lives for the duration of a traced function: its constructor calls the 'before' hook
+ * and its destructor the 'after' hook, so no return path is missed. Only the outermost traced call of a
+ * thread makes an event, the nested ones add their nodes and callbacks to it.
+ */
+static list_trace_hook_func *trace_before = NULL;
+static list_trace_hook_func *trace_after = NULL;
+static void *trace_arg = NULL;
+static thread_local list_trace_event_t *trace_current = NULL; // event of the traced call running on this thread
+
+static const char *trace_op_names[LIST_OP_COUNT] = {
+	"create", "free", "size", "insert", "remove", "free_at", "get_reference", "get_element", "index_of",
+	"print", "create_from_array", "to_array", "unique", "intersect", "difference", "union", "sort", "sort_parallel",
+	"remove_element", "free_element", "compact"
+};
+
+static inline unsigned long long list_trace_clock( void )
+{
+#ifdef LIST_TRACE_TSC
+	return __rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec*1000000000ull + ts.tv_nsec;
+#endif
+}
+
+struct list_trace_scope {
+	list_trace_event_t event;
+	int active;
+
+	list_trace_scope( int op, list_pt list, int index )
+	{
+		active = (trace_current == NULL && (trace_before != NULL || trace_after != NULL));
+		if(!active) return;
+		event.op = op;
+		event.list = list;
+		event.index = index;
+		event.num_of_node = 0;
+		event.num_of_callback = 0;
+		event.callback_time = 0;
+		event.elapsed = 0;
+		trace_current = &event;
+		event.start = list_trace_clock();
+		if(trace_before != NULL) trace_before(&event, trace_arg);
+	}
+
+	~list_trace_scope()
+	{
+		if(!active) return;
+		event.elapsed = list_trace_clock() - event.start;
+		trace_current = NULL;
+		if(trace_after != NULL) trace_after(&event, trace_arg);
+	}
+};
+
+static int list_trace_compare( list_pt list, list_elm_pt x, list_elm_pt y )
+{
+	unsigned long long start;
+	int result;
+	if(trace_current == NULL) return list->element_compare(x, y);
+	start = list_trace_clock();
+	result = list->element_compare(x, y);
+	trace_current->callback_time += list_trace_clock() - start;
+	trace_current->num_of_callback++;
+	return result;
+}
+
+static void list_trace_copy( element_copy_func *element_copy, list_elm_pt *dest, list_elm_pt src )
+{
+	unsigned long long start;
+	if(trace_current == NULL)
+	{
+		element_copy(dest, src);
+		return;
+	}
+	start = list_trace_clock();
+	element_copy(dest, src);
+	trace_current->callback_time += list_trace_clock() - start;
+	trace_current->num_of_callback++;
+}
+
+static void list_trace_free( element_free_func *element_free, list_elm_pt *element )
+{
+	unsigned long long start;
+	if(trace_current == NULL)
+	{
+		element_free(element);
+		return;
+	}
+	start = list_trace_clock();
+	element_free(element);
+	trace_current->callback_time += list_trace_clock() - start;
+	trace_current->num_of_callback++;
+}
+
+	#define LIST_TRACE_SCOPE(op, list, index) list_trace_scope trace_scope(op, list, index)
+	#define LIST_TRACE_NODES(n) do { if(trace_current != NULL) trace_current->num_of_node += (n); } while(0)
+	#define LIST_COMPARE(list, x, y) list_trace_compare(list, x, y)
+	#define LIST_COPY(func, dest, src) list_trace_copy(func, dest, src)
+	#define LIST_FREE(func, element) list_trace_free(func, element)
+#else
+	#define LIST_TRACE_SCOPE(op, list, index) (void)0
+	#define LIST_TRACE_NODES(n) (void)0
+	#define LIST_COMPARE(list, x, y) (list)->element_compare(x, y)
+	#define LIST_COPY(func, dest, src) (func)(dest, src)
+	#define LIST_FREE(func, element) (func)(element)
+#endif
+
+/*
+ * Private functions
+ */
+static list_node_pt list_node_at( list_pt list, int index )
+{
+	int i;
+	list_node_pt node_ptr;
+	if(list->num_of_tombstone > 0)
+	{
+		//count live nodes only, the number of tombstones on the way is unknown
+		if(index > list->num_of_element/2)
+		{
+			i = list->num_of_element-1;
+			for(node_ptr = list->tail; LIST_IS_TOMBSTONE(node_ptr) || i-- > index; node_ptr = node_ptr->prev) LIST_TRACE_NODES(1);
+			return node_ptr;
+		}
+		i = 0;
+		for(node_ptr = list->head; LIST_IS_TOMBSTONE(node_ptr) || i++ < index; node_ptr = node_ptr->next) LIST_TRACE_NODES(1);
+		return node_ptr;
+	}
+	if(index > list->num_of_element/2)
+	{
+		node_ptr = list->tail; //walk back from the end of 'list'
+		LIST_TRACE_NODES(list->num_of_element-1 - index);
+		for(i=list->num_of_element-1; i > index; i--)
+		{
+			node_ptr = node_ptr->prev;
+		}
+		return node_ptr;
+	}
+	node_ptr = list->head;
+	LIST_TRACE_NODES(index);
+	for(i=1; i <= index; i++)
+	{
+		node_ptr = node_ptr->next; //point to index pos
+	}
+	return node_ptr;
+}
+// Walks to the list node at position 'index' from the nearest end. 'list' must not be empty and 'index' must already be clamped.
+
+static void list_unlink( list_pt list, list_node_pt node )
+{
+	if(node->prev == NULL) list->head = node->next;
+	else node->prev->next = node->next;
+	if(node->next == NULL) list->tail = node->prev;
+	else node->next->prev = node->prev;
+	list->num_of_element--;
+}
+// Detaches 'node' from 'list'. The node itself is not freed.
+
+static list_node_pt list_node_alloc( list_pt list )
+{
+	list_node_pt node = list->spare;
+	if(node == NULL)
+	{
+#ifdef LIST_NODE_CACHE
+		return node_cache_get();
+#else
+		return (list_node_pt)malloc(sizeof(list_node_t));
+#endif
+	}
+	list->spare = node->next;
+	return node;
+}
+// Returns an unused block node of 'list' if there is one, a cached or newly-allocated node otherwise.
+
+static void list_node_delete( list_node_pt node )
+{
+#ifdef LIST_NODE_CACHE
+	node_cache_put(node);
+#else
+	free(node);
+#endif
+}
+// Frees a node that is not part of a block.
+
+static void list_node_release( list_pt list, list_node_pt node )
+{
+	if(list->blocks != NULL)
+	{
+		//nodes of a block can't be freed one by one and finding out which block a node is from takes a search:
+		//keep every released node for the next insert, mylist_free sorts them out
+		node->next = list->spare;
+		list->spare = node;
+		return;
+	}
+	list_node_delete(node);
+}
+// Gives back a node that was detached from 'list'.
+
+static void list_compact( list_pt list )
+{
+	list_node_pt temp, next, prev = NULL;
+
+	if(list->num_of_tombstone == 0) return;
+	LIST_TRACE_NODES(list->num_of_element + list->num_of_tombstone);
+	//one pass: relink the live nodes and give back the tombstones
+	for(temp = list->head; temp != NULL; temp = next)
+	{
+		next = temp->next;
+		if(LIST_IS_TOMBSTONE(temp))
+		{
+			list_node_release(list, temp);
+			continue;
+		}
+		temp->prev = prev;
+		if(prev == NULL) list->head = temp;
+		else prev->next = temp;
+		prev = temp;
+	}
+	if(prev == NULL) list->head = NULL;
+	else prev->next = NULL;
+	list->tail = prev;
+	list->num_of_tombstone = 0;
+}
+// Unlinks and gives back all tombstones of 'list' in one pass.
+
+static list_node_pt list_find_element( list_pt list, list_elm_pt element )
+{
+	list_node_pt temp;
+	long num_of_node = 0;
+	for(temp = list->head; temp != NULL; temp = temp->next)
+	{
+		num_of_node++;
+		if(!LIST_IS_TOMBSTONE(temp) && LIST_COMPARE(list, temp->element, element) == 0) break;
+	}
+	LIST_TRACE_NODES(num_of_node);
+	return temp;
+}
+// Returns the first live node of 'list' whose element compares equal to 'element', or NULL.
+
+/*
+ * Private functions - set operations
+ * With an 'element_hash' callback the nodes of one list are put in an open addressing hash table,
+ * without it an array of node pointers is sorted (stable) with 'element_compare' and searched by bisection.
+ */
+typedef struct list_hash_entry {
+	unsigned long hash;
+	list_node_pt node;
+} list_hash_entry_t;
+
+typedef struct list_node_set {
+	list_pt list;
+	list_hash_entry_t *table; // hash table of 'mask'+1 entries, or NULL
+	size_t mask;
+	list_node_pt *nodes;      // sorted node pointers when there is no hash callback
+	int num_of_node;
+} list_node_set_t;
+
+static void list_node_array_sort( list_pt list, list_node_pt *nodes, list_node_pt *tmp, int n )
+{
+	int width, i, left, mid, right, a, b, k;
+	list_node_pt *src = nodes, *dst = tmp, *swap;
+
+	for(width = 1; width < n; width *= 2)
+	{
+		for(i = 0; i < n; i += 2*width)
+		{
+			left = i;
+			mid = (i+width < n) ? i+width : n;
+			right = (i+2*width < n) ? i+2*width : n;
+			a = left; b = mid; k = left;
+			while(a < mid && b < right)
+			{
+				//take from the left run on equality to keep the sort stable
+				if(LIST_COMPARE(list, src[b]->element, src[a]->element) < 0) dst[k++] = src[b++];
+				else dst[k++] = src[a++];
+			}
+			while(a < mid) dst[k++] = src[a++];
+			while(b < right) dst[k++] = src[b++];
+		}
+		swap = src; src = dst; dst = swap;
+	}
+	if(src != nodes) memcpy(nodes, src, n*sizeof(list_node_pt));
+}
+// Sorts 'n' node pointers by their element (bottom-up merge sort, stable). 'tmp' must hold 'n' pointers.
+
+static void list_node_set_add( list_node_set_t *set, list_node_pt node, unsigned long h )
+{
+	size_t slot;
+	for(slot = h & set->mask; set->table[slot].node != NULL; slot = (slot+1) & set->mask);
+	set->table[slot].hash = h;
+	set->table[slot].node = node;
+}
+// Puts 'node' with element hash 'h' in the hash table of the set.
+
+static int list_node_set_create( list_node_set_t *set, list_pt list, int fill )
+{
+	list_node_pt temp;
+	list_node_pt *tmp;
+	size_t size;
+	int i = 0;
+
+	set->list = list;
+	set->table = NULL;
+	set->nodes = NULL;
+	set->num_of_node = list->num_of_element;
+	if(list->element_hash != NULL)
+	{
+		for(size = 16; size < 2*(size_t)list->num_of_element; size *= 2);
+		set->table = (list_hash_entry_t *)calloc(size, sizeof(list_hash_entry_t));
+		if(set->table == NULL) return LIST_MEMORY_ERROR;
+		set->mask = size-1;
+		if(fill)
+		{
+			LIST_TRACE_NODES(list->num_of_element);
+			for(temp = list->head; temp != NULL; temp = temp->next)
+			{
+				if(!LIST_IS_TOMBSTONE(temp)) list_node_set_add(set, temp, list->element_hash(temp->element));
+			}
+		}
+		return LIST_NO_ERROR;
+	}
+	set->nodes = (list_node_pt *)malloc((list->num_of_element+1)*sizeof(list_node_pt));
+	tmp = (list_node_pt *)malloc((list->num_of_element+1)*sizeof(list_node_pt));
+	if(set->nodes == NULL || tmp == NULL)
+	{
+		free(set->nodes);
+		free(tmp);
+		set->nodes = NULL;
+		return LIST_MEMORY_ERROR;
+	}
+	LIST_TRACE_NODES(list->num_of_element);
+	for(temp = list->head; temp != NULL; temp = temp->next)
+	{
+		if(!LIST_IS_TOMBSTONE(temp)) set->nodes[i++] = temp;
+	}
+	list_node_array_sort(list, set->nodes, tmp, set->num_of_node);
+	free(tmp);
+	return LIST_NO_ERROR;
+}
+// Indexes the nodes of 'list' for lookups by element. With a hash callback the table is left empty if 'fill' is 0,
+// without one the sorted node array is always built. Returns LIST_MEMORY_ERROR if memory allocation failed.
+
+static list_node_pt list_node_set_find( list_node_set_t *set, list_elm_pt element, unsigned long h )
+{
+	size_t slot;
+	int low = 0, high = set->num_of_node, mid;
+	list_pt list = set->list;
+
+	if(set->table != NULL)
+	{
+		for(slot = h & set->mask; set->table[slot].node != NULL; slot = (slot+1) & set->mask)
+		{
+			if(set->table[slot].hash == h && LIST_COMPARE(list, set->table[slot].node->element, element) == 0) return set->table[slot].node;
+		}
+		return NULL;
+	}
+	while(low < high) //lower bound
+	{
+		mid = low + (high-low)/2;
+		if(LIST_COMPARE(list, set->nodes[mid]->element, element) < 0) low = mid+1;
+		else high = mid;
+	}
+	if(low < set->num_of_node && LIST_COMPARE(list, set->nodes[low]->element, element) == 0) return set->nodes[low];
+	return NULL;
+}
+// Returns the node of the set whose element compares equal to 'element' (the first one in list order if there are several), or NULL.
+// 'h' is the hash of 'element', it is ignored without hash callback.
+
+static void list_node_set_free( list_node_set_t *set )
+{
+	free(set->table);
+	free(set->nodes);
+}
+
+static int list_filter( list_pt list, list_pt other, int keep_if_found )
+{
+	list_node_set_t set;
+	list_node_pt temp, next;
+	int status, found;
+
+	//check if the lists are NULL
+	if(list == NULL || other == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	if(list == other)
+	{
+		//every element is found in the list itself: intersect keeps all, difference deletes all
+		if(keep_if_found) return LIST_NO_ERROR;
+		list_compact(list);
+		LIST_TRACE_NODES(list->num_of_element);
+		while(list->head != NULL)
+		{
+			temp = list->head;
+			list_unlink(list, temp);
+			LIST_FREE(list->element_free, &(temp->element));
+			list_node_release(list, temp);
+		}
+		return LIST_NO_ERROR;
+	}
+	status = list_node_set_create(&set, other, 1);
+	if(status != LIST_NO_ERROR) return status;
+	list_compact(list);
+	LIST_TRACE_NODES(list->num_of_element);
+	for(temp = list->head; temp != NULL; temp = next)
+	{
+		next = temp->next;
+		found = list_node_set_find(&set, temp->element, (other->element_hash != NULL) ? other->element_hash(temp->element) : 0) != NULL;
+		if(found != keep_if_found)
+		{
+			list_unlink(list, temp);
+			LIST_FREE(list->element_free, &(temp->element));
+			list_node_release(list, temp);
+		}
+	}
+	list_node_set_free(&set);
+	return LIST_NO_ERROR;
+}
+// Deletes the nodes of 'list' whose element is found (keep_if_found 0) or not found (keep_if_found 1) in 'other'.
+// 'other' may be 'list' itself.
+
+/*
+ * Private functions - sort
+ * The sort works on a chain: nodes linked by 'next' only and ended by NULL. 'prev', 'head' and 'tail'
+ * are restored by list_relink afterwards. Nodes are only relinked, no element is copied.
+ */
+static list_node_pt list_chain_merge( list_pt list, list_node_pt a, list_node_pt b )
+{
+	list_node_t first;
+	list_node_pt last = &first;
+
+	while(a != NULL && b != NULL)
+	{
+		//take from 'a' on equality to keep the sort stable
+		if(LIST_COMPARE(list, b->element, a->element) < 0)
+		{
+			last->next = b;
+			b = b->next;
+		}
+		else
+		{
+			last->next = a;
+			a = a->next;
+		}
+		last = last->next;
+	}
+	last->next = (a != NULL) ? a : b;
+	return first.next;
+}
+// Merges the sorted chains 'a' and 'b' ('a' holds the nodes that came first in the list) and returns the merged chain.
+
+static list_node_pt list_chain_sort( list_pt list, list_node_pt chain )
+{
+	list_node_pt bins[64], run; // bins[i] is empty or a sorted chain of 2^i nodes, higher bins hold earlier nodes
+	int i, num_of_bin = 0;
+
+	while(chain != NULL)
+	{
+		run = chain;
+		chain = chain->next;
+		run->next = NULL;
+		for(i = 0; i < num_of_bin && bins[i] != NULL; i++)
+		{
+			run = list_chain_merge(list, bins[i], run);
+			bins[i] = NULL;
+		}
+		if(i == num_of_bin) num_of_bin++;
+		bins[i] = run;
+	}
+	run = NULL;
+	for(i = 0; i < num_of_bin; i++)
+	{
+		if(bins[i] != NULL) run = list_chain_merge(list, bins[i], run);
+	}
+	return run;
+}
+// Bottom-up stable merge sort of 'chain' with 'element_compare'. Returns the sorted chain.
+
+static void list_relink( list_pt list, list_node_pt chain )
+{
+	list_node_pt temp, prev = NULL;
+	for(temp = chain; temp != NULL; temp = temp->next)
+	{
+		temp->prev = prev;
+		prev = temp;
+	}
+	LIST_TRACE_NODES(list->num_of_element);
+	list->head = chain;
+	list->tail = prev;
+}
+// Makes the chain 'chain' the node sequence of 'list' again.
+
+#ifdef LIST_PARALLEL
+/*
+ * Parallel sort: the chain is cut in runs, every run is a leaf task and every pair of neighbouring
+ * subtrees is merged by a parent task, so merging always takes the earlier nodes from the left.
+ * Every worker owns a deque of ready tasks: it pushes and pops at the bottom and steals the oldest task
+ * (top) of another deque when its own is empty. The task that completes the second child of a parent
+ * pushes the parent on its own deque, so a merge usually runs on the thread that has one of its runs in cache.
+ * A worker that finds no task sleeps on the pool condition until a task is pushed or the sort is done,
+ * so idle workers leave the CPU to the ones that merge, also when there are more threads than processors.
+ */
+typedef struct list_sort_task {
+	list_node_pt chain;              // leaf: unsorted run, when done: sorted chain of the subtree
+	struct list_sort_task *left;     // NULL for a leaf
+	struct list_sort_task *right;
+	struct list_sort_task *parent;   // NULL for the root
+	int pending;                     // children that are not done yet
+} list_sort_task_t;
+
+typedef struct list_sort_deque {
+	pthread_mutex_t lock;
+	list_sort_task_t **tasks;
+	int top;
+	int bottom;
+} list_sort_deque_t;
+
+typedef struct list_sort_pool {
+	list_pt list;
+	list_sort_deque_t *deques;
+	int num_of_worker;
+	pthread_mutex_t lock;            // protects 'num_of_ready' and 'done' for the sleeping workers
+	pthread_cond_t wake;             // signalled when a task is pushed or the root task is done
+	int num_of_ready;                // tasks pushed on any deque and not taken yet
+	int done;
+} list_sort_pool_t;
+
+typedef struct list_sort_worker {
+	list_sort_pool_t *pool;
+	int id;
+} list_sort_worker_t;
+
+static void list_sort_push( list_sort_pool_t *pool, int id, list_sort_task_t *task )
+{
+	list_sort_deque_t *deque = &pool->deques[id];
+	pthread_mutex_lock(&deque->lock);
+	deque->tasks[deque->bottom++] = task;
+	pthread_mutex_unlock(&deque->lock);
+	//counted under the pool lock, so a worker can't miss the wake-up between its check and its wait
+	pthread_mutex_lock(&pool->lock);
+	__atomic_add_fetch(&pool->num_of_ready, 1, __ATOMIC_RELAXED);
+	pthread_cond_signal(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+}
+// Pushes 'task' on the deque of worker 'id' and wakes a sleeping worker.
+
+static list_sort_task_t *list_sort_pop( list_sort_pool_t *pool, int id, int steal )
+{
+	list_sort_deque_t *deque = &pool->deques[id];
+	list_sort_task_t *task = NULL;
+	pthread_mutex_lock(&deque->lock);
+	if(deque->top < deque->bottom) task = steal ? deque->tasks[deque->top++] : deque->tasks[--deque->bottom];
+	pthread_mutex_unlock(&deque->lock);
+	if(task != NULL) __atomic_sub_fetch(&pool->num_of_ready, 1, __ATOMIC_RELAXED);
+	return task;
+}
+// Takes the newest task of the deque of worker 'id' (the oldest one if 'steal' is set), or returns NULL if it is empty.
+
+static void *list_sort_work( void *arg )
+{
+	list_sort_worker_t *worker = (list_sort_worker_t *)arg;
+	list_sort_pool_t *pool = worker->pool;
+	list_sort_task_t *task;
+	int i;
+
+	for(;;)
+	{
+		task = list_sort_pop(pool, worker->id, 0);
+		for(i = 1; task == NULL && i < pool->num_of_worker; i++)
+		{
+			task = list_sort_pop(pool, (worker->id + i) % pool->num_of_worker, 1);
+		}
+		if(task == NULL)
+		{
+			//sleep until there is a task to take or the sort is done
+			pthread_mutex_lock(&pool->lock);
+			while(!pool->done && __atomic_load_n(&pool->num_of_ready, __ATOMIC_RELAXED) == 0) pthread_cond_wait(&pool->wake, &pool->lock);
+			i = pool->done;
+			pthread_mutex_unlock(&pool->lock);
+			if(i) break;
+			continue;
+		}
+		if(task->left == NULL) task->chain = list_chain_sort(pool->list, task->chain);
+		else task->chain = list_chain_merge(pool->list, task->left->chain, task->right->chain);
+		if(task->parent == NULL)
+		{
+			pthread_mutex_lock(&pool->lock);
+			pool->done = 1;
+			pthread_cond_broadcast(&pool->wake);
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		if(__atomic_sub_fetch(&task->parent->pending, 1, __ATOMIC_ACQ_REL) == 0) list_sort_push(pool, worker->id, task->parent);
+	}
+	return NULL;
+}
+// Runs tasks of the own deque, or stolen ones, until the root task is done. Sleeps while there is no task.
+
+static list_sort_task_t *list_sort_tree( list_sort_pool_t *pool, list_sort_task_t *tasks, int *num_of_task, list_node_pt *runs, int first, int last, list_sort_task_t *parent )
+{
+	list_sort_task_t *task = &tasks[(*num_of_task)++];
+	int mid;
+
+	task->parent = parent;
+	if(last - first == 1)
+	{
+		task->chain = runs[first];
+		task->left = NULL;
+		task->right = NULL;
+		task->pending = 0;
+		list_sort_push(pool, first % pool->num_of_worker, task);
+		return task;
+	}
+	mid = (first + last) / 2;
+	task->chain = NULL;
+	task->left = list_sort_tree(pool, tasks, num_of_task, runs, first, mid, task);
+	task->right = list_sort_tree(pool, tasks, num_of_task, runs, mid, last, task);
+	task->pending = 2;
+	return task;
+}
+// Builds the merge tree over runs['first'..'last'[ and deals the leaves round-robin over the deques. Returns the subtree root.
+#endif
+
+/*
+ * Public functions - status returning API
+ * Every function returns LIST_NO_ERROR or one of the error codes and never touches list_errno,
+ * so they can be used from several threads as long as a single list is not modified concurrently.
+ */
+int mylist_create_r( list_pt *list, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print )
+{
+	LIST_TRACE_SCOPE(LIST_OP_CREATE, NULL, -1);
+	list_pt mylist = (list_pt) malloc(sizeof(list_t)); // list allocated
 	if(mylist == NULL)
 	{
 		DEBUG_PRINT( "DEBUG:: Error in list allocating\n" );
-		list_errno = LIST_MEMORY_ERROR;
-		return NULL;
-	}	
+		*list = NULL;
+		return LIST_MEMORY_ERROR;
+	}
 	mylist->head = NULL;
+	mylist->tail = NULL;
 	mylist->num_of_element = 0;
+	mylist->blocks = NULL;
+	mylist->spare = NULL;
 	mylist->element_copy = element_copy;
 	mylist->element_free = element_free;
 	mylist->element_compare = element_compare;
 	mylist->element_print = element_print;
-	return mylist;
-} 
-// Returns a pointer to a newly-allocated list.
-// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR 
+	mylist->element_hash = NULL;
+	mylist->num_of_tombstone = 0;
+	mylist->max_tombstone_ratio = 0;
+	*list = mylist;
+	return LIST_NO_ERROR;
+}
+// Stores a pointer to a newly-allocated list in '*list'.
+// Returns LIST_MEMORY_ERROR and stores NULL if memory allocation failed.
+
+int mylist_free_r( list_pt *list )
+{
+	LIST_TRACE_SCOPE(LIST_OP_FREE, (list == NULL) ? NULL : *list, -1);
+	list_node_pt temp, next;
+	list_node_block_t *block;
+	int i;
 
-void mylist_free( list_pt* list )
-{	
-	int i=0;
-	list_node_pt temp = (*list)->head;
-		
-	list_errno = LIST_NO_ERROR;
 	//check if the list is NULL
-	if(*list == NULL) 
+	if(list == NULL || *list == NULL)
 	{
 		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return;	
-	}	
+		return LIST_INVALID_ERROR;
+	}
+	//free element of each node and the node itself
+	LIST_TRACE_NODES((*list)->num_of_element + (*list)->num_of_tombstone);
+	temp = (*list)->head;
+	while(temp != NULL)
+	{
+		next = temp->next;
+		if(!LIST_IS_TOMBSTONE(temp)) LIST_FREE((*list)->element_free, &(temp->element));
+		if((*list)->blocks == NULL) list_node_delete(temp);
+		temp = next;
+	}
+	if((*list)->blocks != NULL)
+	{
+		//mark the nodes of the blocks, then free the other linked and spare nodes one by one
+		for(block = (*list)->blocks; block != NULL; block = block->next)
+		{
+			for(i = 0; i < block->num_of_node; i++) block->node[i].element = (list_elm_pt)&list_block_mark;
+		}
+		for(temp = (*list)->head; temp != NULL; temp = next)
+		{
+			next = temp->next;
+			if(temp->element != (list_elm_pt)&list_block_mark) list_node_delete(temp);
+		}
+		for(temp = (*list)->spare; temp != NULL; temp = next)
+		{
+			next = temp->next;
+			if(temp->element != (list_elm_pt)&list_block_mark) list_node_delete(temp);
+		}
+	}
+	//nodes of a block are freed all at once
+	while((*list)->blocks != NULL)
+	{
+		block = (*list)->blocks;
+		(*list)->blocks = block->next;
+		free(block);
+	}
+	free(*list);
+	*list = NULL;
+	return LIST_NO_ERROR;
+}
+// Every list node and node element of the list is deleted and '*list' is set to NULL.
+// Returns LIST_INVALID_ERROR if 'list' or '*list' is NULL.
+
+int mylist_size_r( list_pt list, int *size )
+{
+	LIST_TRACE_SCOPE(LIST_OP_SIZE, list, -1);
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG::List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	*size = list->num_of_element;
+	return LIST_NO_ERROR;
+}
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_insert_at_index_r( list_pt list, list_elm_pt element, int index )
+{
+	LIST_TRACE_SCOPE(LIST_OP_INSERT, list, index);
+	list_node_pt new_node;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	new_node = list_node_alloc(list);
+	if(new_node == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in allocating a new list_node\n" );
+		return LIST_MEMORY_ERROR;
+	}
+	LIST_COPY(list->element_copy, &(new_node->element), element); //make a deep copy
+
+	//the list node is inserted at the start of 'list'
+	if(index <= 0 || list->num_of_element == 0)
+	{
+		new_node->prev = NULL;
+		new_node->next = list->head;
+		if(list->head != NULL) list->head->prev = new_node;
+		else list->tail = new_node;
+		list->head = new_node;
+	}
+	else
+	{
+		//the list node is inserted after the node at 'index'-1, or at the end of 'list'
+		if(index > list->num_of_element) index = list->num_of_element;
+		list_node_pt temp = list_node_at(list, index-1);
+		new_node->prev = temp;
+		new_node->next = temp->next;
+		if(temp->next != NULL) temp->next->prev = new_node;
+		else list->tail = new_node;
+		temp->next = new_node;
+	}
+	list->num_of_element++;
+	return LIST_NO_ERROR;
+}
+// Inserts a new list node containing a copy of 'element' in 'list' at position 'index' (same clamping as mylist_insert_at_index).
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_MEMORY_ERROR if memory allocation failed.
+
+int mylist_remove_at_index_r( list_pt list, int index )
+{
+	LIST_TRACE_SCOPE(LIST_OP_REMOVE, list, index);
+	list_node_pt temp;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
 	//Check the list is empty
-	if((*list)->num_of_element == 0)
-	{	  
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (list->num_of_element)) index = list->num_of_element-1;
+
+	temp = list_node_at(list, index);
+	list_unlink(list, temp);
+	list_node_release(list, temp);
+	return LIST_NO_ERROR;
+}
+// Removes the list node at index 'index' from 'list' (same clamping as mylist_remove_at_index). NO free() is called on the element pointer.
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_EMPTY_ERROR if 'list' is empty.
+
+int mylist_free_at_index_r( list_pt list, int index )
+{
+	LIST_TRACE_SCOPE(LIST_OP_FREE_AT, list, index);
+	list_node_pt temp;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (list->num_of_element)) index = list->num_of_element-1;
+
+	temp = list_node_at(list, index);
+	list_unlink(list, temp);
+	LIST_FREE(list->element_free, &(temp->element));
+	list_node_release(list, temp);
+	return LIST_NO_ERROR;
+}
+// Deletes the list node at index 'index' in 'list' and frees its element (same clamping as mylist_free_at_index).
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_EMPTY_ERROR if 'list' is empty.
+
+int mylist_get_reference_at_index_r( list_pt list, int index, list_node_pt *reference )
+{
+	LIST_TRACE_SCOPE(LIST_OP_GET_REFERENCE, list, index);
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		*reference = NULL;
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		*reference = NULL;
+		return LIST_EMPTY_ERROR;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (list->num_of_element)) index = list->num_of_element-1;
+	*reference = list_node_at(list, index);
+	return LIST_NO_ERROR;
+}
+// Stores a reference to the list node with index 'index' in '*reference' (same clamping as mylist_get_reference_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+int mylist_get_element_at_index_r( list_pt list, int index, list_elm_pt *element )
+{
+	LIST_TRACE_SCOPE(LIST_OP_GET_ELEMENT, list, index);
+	list_node_pt temp;
+	int status = mylist_get_reference_at_index_r(list, index, &temp);
+	*element = (temp == NULL) ? NULL : temp->element; //an element pointer of the list (not a copy)-> be careful!!!
+	return status;
+}
+// Stores the element contained in the list node with index 'index' in '*element' (same clamping as mylist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+int mylist_get_index_of_element_r( list_pt list, list_elm_pt element, int *index )
+{
+	LIST_TRACE_SCOPE(LIST_OP_INDEX_OF, list, -1);
+	*index = -1;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check the element is NULL
+	if(element == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Input element is NULL\n" );
+		return ELEMENT_INVALID_ERROR;
+	}
+	int i=0;
+	list_node_pt temp = list->head;
+	if(list->num_of_tombstone > 0)
+	{
+		//the position counts live nodes only
+		temp = list_find_element(list, element);
+		if(temp == NULL) return LIST_NO_ERROR;
+		for(temp = temp->prev; temp != NULL; temp = temp->prev) i += !LIST_IS_TOMBSTONE(temp);
+		*index = i;
+		return LIST_NO_ERROR;
+	}
+	while(temp != NULL)
+	{
+		if(LIST_COMPARE(list, temp->element, element) == 0)
+		{
+			LIST_TRACE_NODES(i+1);
+			*index = i;
+			return LIST_NO_ERROR;
+		}
+		temp = temp->next;
+		i++;
+	}
+	// If 'element' is not found in 'list'
+	LIST_TRACE_NODES(i);
+	return LIST_NO_ERROR;
+}
+// Stores the index of the first list node in 'list' containing 'element' in '*index', or -1 if 'element' is not found.
+// Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mylist_print_r( list_pt list )
+{
+	LIST_TRACE_SCOPE(LIST_OP_PRINT, list, -1);
+	list_node_pt temp;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	LIST_TRACE_NODES(list->num_of_element);
+	for(temp = list->head; temp != NULL; temp = temp->next)
+	{
+		if(!LIST_IS_TOMBSTONE(temp)) list->element_print(temp->element);
+	}
+	return LIST_NO_ERROR;
+}
+// for testing purposes: print the entire list on screen
+// Returns LIST_INVALID_ERROR or LIST_EMPTY_ERROR on error.
+
+int mylist_create_from_array_r( list_pt *list, list_elm_pt array, int num_of_element, int element_size, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print )
+{
+	LIST_TRACE_SCOPE(LIST_OP_CREATE_FROM_ARRAY, NULL, -1);
+	int i, status;
+	list_node_block_t *block;
+	list_node_pt node;
+
+	*list = NULL;
+	//Check the array is NULL
+	if(num_of_element > 0 && array == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Input array is NULL\n" );
+		return ELEMENT_INVALID_ERROR;
+	}
+	status = mylist_create_r(list, element_copy, element_free, element_compare, element_print);
+	if(status != LIST_NO_ERROR || num_of_element <= 0) return status;
+
+	//all nodes are allocated in one block
+	block = (list_node_block_t *)malloc(sizeof(list_node_block_t) + (num_of_element-1)*sizeof(list_node_t));
+	if(block == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in allocating a list_node block\n" );
 		free(*list);
 		*list = NULL;
-		return;
-	}			
-	//free element of each node
-	for(i=0; i < (*list)->num_of_element; i++)
+		return LIST_MEMORY_ERROR;
+	}
+	block->next = NULL;
+	block->num_of_node = num_of_element;
+	(*list)->blocks = block;
+
+	//link the nodes in one pass
+	LIST_TRACE_NODES(num_of_element);
+	for(i=0; i < num_of_element; i++)
 	{
-		(*list)->element_free(&(temp->element));
-		if(i != (*list)->num_of_element-1) temp=temp->next;			
-	}	
-	//free each node
-	for(i=0; i < (*list)->num_of_element; i++)
+		node = &(block->node[i]);
+		LIST_COPY(element_copy, &(node->element), (char *)array + (size_t)i*element_size); //make a deep copy
+		node->prev = (i == 0) ? NULL : node-1;
+		node->next = (i == num_of_element-1) ? NULL : node+1;
+	}
+	(*list)->head = &(block->node[0]);
+	(*list)->tail = &(block->node[num_of_element-1]);
+	(*list)->num_of_element = num_of_element;
+	return LIST_NO_ERROR;
+}
+// Stores a pointer to a newly-allocated list holding a copy of the 'num_of_element' elements of 'array' in '*list'.
+// Element i is copied with 'element_copy' from address 'array' + i*'element_size'.
+// Returns ELEMENT_INVALID_ERROR if 'array' is NULL or LIST_MEMORY_ERROR if memory allocation failed; NULL is stored then.
+
+#ifdef LIST_PARALLEL
+typedef struct list_export_job {
+	list_node_pt node;
+	char *dest;
+	int num_of_element;
+	int element_size;
+} list_export_job_t;
+
+static void *list_export_backward( void *arg )
+{
+	list_export_job_t *job = (list_export_job_t *)arg;
+	list_node_pt temp = job->node;
+	char *dest = job->dest;
+	int i;
+	for(i=0; i < job->num_of_element; i++)
 	{
-		if(i != (*list)->num_of_element-1) temp=temp->prev;				
-		free(temp->next);
+		memcpy(dest, temp->element, job->element_size);
+		dest -= job->element_size;
+		temp = temp->prev;
+	}
+	return NULL;
+}
+// Copies 'num_of_element' elements walking back from 'node', the first one to 'dest'.
+#endif
+
+int mylist_to_array_r( list_pt list, list_elm_pt array, int size, int element_size, int *num_of_copied )
+{
+	LIST_TRACE_SCOPE(LIST_OP_TO_ARRAY, list, -1);
+	int i, count;
+	char *dest = (char *)array;
+	list_node_pt temp;
+
+	*num_of_copied = 0;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the array is NULL
+	if(size > 0 && array == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Output array is NULL\n" );
+		return ELEMENT_INVALID_ERROR;
+	}
+	count = (size < list->num_of_element) ? size : list->num_of_element;
+	if(count <= 0) return LIST_NO_ERROR;
+	LIST_TRACE_NODES(count);
+	temp = list->head;
+	if(list->num_of_tombstone > 0)
+	{
+		//skip the tombstones on one thread
+		for(i=0; i < count; temp = temp->next)
+		{
+			if(LIST_IS_TOMBSTONE(temp)) continue;
+			memcpy(dest, temp->element, element_size);
+			dest += element_size;
+			i++;
+		}
+		*num_of_copied = count;
+		return LIST_NO_ERROR;
+	}
+#ifdef LIST_PARALLEL
+	//the whole list is exported: a second thread walks back from the tail and fills the upper half
+	pthread_t thread;
+	list_export_job_t job;
+	int half = count;
+	if(count == list->num_of_element && count >= LIST_PARALLEL_MIN)
+	{
+		half = count/2;
+		job.node = list->tail;
+		job.dest = dest + (size_t)(count-1)*element_size;
+		job.num_of_element = count - half;
+		job.element_size = element_size;
+		if(pthread_create(&thread, NULL, list_export_backward, &job) != 0) half = count;
+	}
+	for(i=0; i < half; i++)
+	{
+		memcpy(dest, temp->element, element_size);
+		dest += element_size;
+		temp = temp->next;
+	}
+	if(half != count) pthread_join(thread, NULL);
+#else
+	for(i=0; i < count; i++)
+	{
+		memcpy(dest, temp->element, element_size);
+		dest += element_size;
+		temp = temp->next;
+	}
+#endif
+	*num_of_copied = count;
+	return LIST_NO_ERROR;
+}
+// Copies the elements of 'list' in order into the caller buffer 'array' in a single traversal ('element_size' bytes each, at most 'size' elements).
+// The number of copied elements is stored in '*num_of_copied'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL or ELEMENT_INVALID_ERROR if 'array' is NULL.
+
+int mylist_set_element_hash_r( list_pt list, element_hash_func *element_hash )
+{
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list->element_hash = element_hash;
+	return LIST_NO_ERROR;
+}
+// Sets the (optional) hash callback of 'list'. Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_unique_r( list_pt list )
+{
+	LIST_TRACE_SCOPE(LIST_OP_UNIQUE, list, -1);
+	list_node_set_t set;
+	list_node_pt temp, next;
+	unsigned long h;
+	int i, status;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list_compact(list);
+	status = list_node_set_create(&set, list, 0);
+	if(status != LIST_NO_ERROR) return status;
+	if(set.table != NULL)
+	{
+		//one pass: a node is deleted if an equal node was already seen
+		LIST_TRACE_NODES(list->num_of_element);
+		for(temp = list->head; temp != NULL; temp = next)
+		{
+			next = temp->next;
+			h = list->element_hash(temp->element);
+			if(list_node_set_find(&set, temp->element, h) == NULL)
+			{
+				list_node_set_add(&set, temp, h);
+				continue;
+			}
+			list_unlink(list, temp);
+			LIST_FREE(list->element_free, &(temp->element));
+			list_node_release(list, temp);
+		}
+	}
+	else
+	{
+		//the sort is stable: in a run of equal elements the first node is the first one in list order
+		for(i = 1; i < set.num_of_node; i++)
+		{
+			if(LIST_COMPARE(list, set.nodes[i-1]->element, set.nodes[i]->element) == 0)
+			{
+				temp = set.nodes[i];
+				set.nodes[i] = set.nodes[i-1]; //compare the rest of the run with the kept node
+				list_unlink(list, temp);
+				LIST_FREE(list->element_free, &(temp->element));
+				list_node_release(list, temp);
+			}
+		}
+	}
+	list_node_set_free(&set);
+	return LIST_NO_ERROR;
+}
+// Deletes every node whose element compares equal to an element before it in 'list', so the first occurrences remain in their order.
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_MEMORY_ERROR if memory allocation failed ('list' is unchanged then).
+
+int mylist_intersect_r( list_pt list, list_pt other )
+{
+	LIST_TRACE_SCOPE(LIST_OP_INTERSECT, list, -1);
+	return list_filter(list, other, 1);
+}
+// Deletes every node of 'list' whose element has no equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, nothing is deleted.
+// Returns LIST_INVALID_ERROR if a list is NULL or LIST_MEMORY_ERROR if memory allocation failed ('list' is unchanged then).
+
+int mylist_difference_r( list_pt list, list_pt other )
+{
+	LIST_TRACE_SCOPE(LIST_OP_DIFFERENCE, list, -1);
+	return list_filter(list, other, 0);
+}
+// Deletes every node of 'list' whose element has an equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, all nodes are deleted.
+// Returns LIST_INVALID_ERROR if a list is NULL or LIST_MEMORY_ERROR if memory allocation failed ('list' is unchanged then).
+
+int mylist_union_r( list_pt list, list_pt other )
+{
+	LIST_TRACE_SCOPE(LIST_OP_UNION, list, -1);
+	list_node_block_t *block;
+	list_node_pt spare;
+
+	//check if the lists are NULL
+	if(list == NULL || other == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//the union of a list with itself holds its elements once
+	if(list == other) return mylist_unique_r(list);
+	//move all nodes of 'other' to the end of 'list'
+	list_compact(list);
+	list_compact(other);
+	if(other->head != NULL)
+	{
+		if(list->tail == NULL) list->head = other->head;
+		else list->tail->next = other->head;
+		other->head->prev = list->tail;
+		list->tail = other->tail;
+		list->num_of_element += other->num_of_element;
+		other->head = NULL;
+		other->tail = NULL;
+		other->num_of_element = 0;
+	}
+	//the node blocks of 'other' move along with their nodes
+	if(other->blocks != NULL)
+	{
+		for(block = other->blocks; block->next != NULL; block = block->next);
+		block->next = list->blocks;
+		list->blocks = other->blocks;
+		other->blocks = NULL;
+	}
+	if(other->spare != NULL)
+	{
+		for(spare = other->spare; spare->next != NULL; spare = spare->next);
+		spare->next = list->spare;
+		list->spare = other->spare;
+		other->spare = NULL;
+	}
+	return mylist_unique_r(list);
+}
+// Moves all nodes of 'other' to the end of 'list' (no element is copied, 'other' becomes empty), then removes the duplicates like mylist_unique.
+// Both lists must use the same callback functions. If 'other' is 'list' itself, only the duplicates are removed.
+// Returns LIST_INVALID_ERROR if a list is NULL.
+// Returns LIST_MEMORY_ERROR if memory allocation failed, the nodes of 'other' are moved but the duplicates are not removed then.
+
+int mylist_sort_r( list_pt list )
+{
+	LIST_TRACE_SCOPE(LIST_OP_SORT, list, -1);
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list_compact(list);
+	if(list->num_of_element < 2) return LIST_NO_ERROR;
+	list_relink(list, list_chain_sort(list, list->head));
+	return LIST_NO_ERROR;
+}
+// Sorts 'list' with 'element_compare' (stable merge sort, the nodes are relinked and no element is copied).
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_sort_parallel_r( list_pt list, int num_of_threads )
+{
+	LIST_TRACE_SCOPE(LIST_OP_SORT_PARALLEL, list, -1);
+#ifdef LIST_PARALLEL
+	list_sort_pool_t pool;
+	list_sort_worker_t *workers;
+	list_sort_task_t *tasks, *root;
+	list_node_pt *runs, temp, next;
+	pthread_t *threads;
+	int *started;
+	int i = 0, j, num_of_run, run_size, num_of_task = 0;
+
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list_compact(list);
+	if(num_of_threads <= 0) num_of_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if(num_of_threads <= 1 || list->num_of_element < LIST_PARALLEL_MIN) return mylist_sort_r(list);
+	//a few runs per thread, so a thread that is done early can steal work
+	num_of_run = 4*num_of_threads;
+	run_size = (list->num_of_element + num_of_run - 1) / num_of_run;
+	num_of_run = (list->num_of_element + run_size - 1) / run_size;
+	runs = (list_node_pt *)malloc(num_of_run * sizeof(list_node_pt));
+	tasks = (list_sort_task_t *)malloc((2*num_of_run - 1) * sizeof(list_sort_task_t));
+	pool.deques = (list_sort_deque_t *)malloc(num_of_threads * sizeof(list_sort_deque_t));
+	workers = (list_sort_worker_t *)malloc(num_of_threads * sizeof(list_sort_worker_t));
+	threads = (pthread_t *)malloc(num_of_threads * sizeof(pthread_t));
+	started = (int *)calloc(num_of_threads, sizeof(int));
+	if(pool.deques != NULL)
+	{
+		for(i = 0; i < num_of_threads; i++) pool.deques[i].tasks = NULL;
+		for(i = 0; i < num_of_threads; i++)
+		{
+			pool.deques[i].tasks = (list_sort_task_t **)malloc((2*num_of_run - 1) * sizeof(list_sort_task_t *));
+			if(pool.deques[i].tasks == NULL) break;
+		}
+	}
+	if(runs == NULL || tasks == NULL || pool.deques == NULL || workers == NULL || threads == NULL || started == NULL || i < num_of_threads)
+	{
+		//the sequential sort needs no memory
+		DEBUG_PRINT("Memory allocation failed, sorting on one thread\n");
+		if(pool.deques != NULL) for(i = 0; i < num_of_threads; i++) free(pool.deques[i].tasks);
+		free(runs);
+		free(tasks);
+		free(pool.deques);
+		free(workers);
+		free(threads);
+		free(started);
+		return mylist_sort_r(list);
+	}
+	//cut the list in runs of 'run_size' nodes
+	temp = list->head;
+	for(i = 0; i < num_of_run; i++)
+	{
+		runs[i] = temp;
+		for(j = 1; j < run_size && temp->next != NULL; j++) temp = temp->next;
+		next = temp->next;
 		temp->next = NULL;
-	}	
-	free((*list)->head);
-	(*list)->head = NULL;
-	free(*list);
-	*list = NULL;
+		temp = next;
+	}
+	pool.list = list;
+	pool.num_of_worker = num_of_threads;
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.wake, NULL);
+	pool.num_of_ready = 0;
+	pool.done = 0;
+	for(i = 0; i < num_of_threads; i++)
+	{
+		pthread_mutex_init(&pool.deques[i].lock, NULL);
+		pool.deques[i].top = 0;
+		pool.deques[i].bottom = 0;
+		workers[i].pool = &pool;
+		workers[i].id = i;
+	}
+	root = list_sort_tree(&pool, tasks, &num_of_task, runs, 0, num_of_run, NULL);
+	//the calling thread is worker 0; the tasks of a worker that could not be started are stolen by the others
+	for(i = 1; i < num_of_threads; i++) started[i] = (pthread_create(&threads[i], NULL, list_sort_work, &workers[i]) == 0);
+	list_sort_work(&workers[0]);
+	for(i = 1; i < num_of_threads; i++)
+	{
+		if(started[i]) pthread_join(threads[i], NULL);
+	}
+	list_relink(list, root->chain);
+	for(i = 0; i < num_of_threads; i++)
+	{
+		pthread_mutex_destroy(&pool.deques[i].lock);
+		free(pool.deques[i].tasks);
+	}
+	pthread_cond_destroy(&pool.wake);
+	pthread_mutex_destroy(&pool.lock);
+	free(runs);
+	free(tasks);
+	free(pool.deques);
+	free(workers);
+	free(threads);
+	free(started);
+	return LIST_NO_ERROR;
+#else
+	(void)num_of_threads;
+	return mylist_sort_r(list);
+#endif
 }
-// Every list node and node element of the list needs to be deleted (free memory)
-// The list itself also needs to be deleted (free all memory) and set to NULL
+// Same result as mylist_sort_r, sorted by 'num_of_threads' threads (the number of processors if 0 or negative).
+// Without LIST_PARALLEL, or for lists shorter than LIST_PARALLEL_MIN, the list is sorted by the calling thread.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+static int list_remove_first_equal( list_pt list, list_elm_pt element, int free_element )
+{
+	list_node_pt temp;
 
-int mylist_size( list_pt list )
-{	
-	list_errno = LIST_NO_ERROR;
 	//check if the list is NULL
-	if(list == NULL) 
+	if(list == NULL)
 	{
-		DEBUG_PRINT( "DEBUG::List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return -1;	
-	}		
-	return list->num_of_element;
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check the element is NULL
+	if(element == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Input element is NULL\n" );
+		return ELEMENT_INVALID_ERROR;
+	}
+	temp = list_find_element(list, element);
+	if(temp == NULL) return LIST_NO_ERROR;
+	if(free_element) LIST_FREE(list->element_free, &(temp->element));
+	if(list->max_tombstone_ratio <= 0)
+	{
+		list_unlink(list, temp);
+		list_node_release(list, temp);
+		return LIST_NO_ERROR;
+	}
+	//lazy removal: the node stays linked as a tombstone until the next compaction
+	temp->element = (list_elm_pt)&list_tombstone_mark;
+	list->num_of_element--;
+	list->num_of_tombstone++;
+	if(list->num_of_tombstone > list->max_tombstone_ratio*(list->num_of_element + list->num_of_tombstone)) list_compact(list);
+	return LIST_NO_ERROR;
+}
+// Removes the first node of 'list' whose element compares equal to 'element' (found in one walk) and frees the element if 'free_element' is set.
+
+int mylist_remove_element_r( list_pt list, list_elm_pt element )
+{
+	LIST_TRACE_SCOPE(LIST_OP_REMOVE_ELEMENT, list, -1);
+	return list_remove_first_equal(list, element, 0);
+}
+// Removes the first list node in 'list' whose element compares equal to 'element'. NO free() is called on the element pointer.
+// Nothing is removed if no element is equal. Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mylist_free_element_r( list_pt list, list_elm_pt element )
+{
+	LIST_TRACE_SCOPE(LIST_OP_FREE_ELEMENT, list, -1);
+	return list_remove_first_equal(list, element, 1);
+}
+// Deletes the first list node in 'list' whose element compares equal to 'element' and frees its element.
+// Nothing is deleted if no element is equal. Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mylist_compact_r( list_pt list )
+{
+	LIST_TRACE_SCOPE(LIST_OP_COMPACT, list, -1);
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list_compact(list);
+	return LIST_NO_ERROR;
+}
+// Unlinks the tombstones left by lazy removal and gives their nodes back in one pass.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_set_lazy_removal_r( list_pt list, double max_tombstone_ratio )
+{
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	list->max_tombstone_ratio = (max_tombstone_ratio > 0) ? max_tombstone_ratio : 0;
+	if(list->max_tombstone_ratio == 0) list_compact(list);
+	return LIST_NO_ERROR;
+}
+// Sets the tombstone ratio of lazy removal (0 turns it off and compacts now).
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+/*
+ * Public functions - list_errno wrappers
+ */
+list_pt mylist_create(element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print){
+	list_pt mylist;
+	list_errno = mylist_create_r(&mylist, element_copy, element_free, element_compare, element_print);
+	return mylist;
+}
+// Returns a pointer to a newly-allocated list.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mylist_free( list_pt* list )
+{
+	list_errno = mylist_free_r(list);
+}
+// Every list node and node element of the list needs to be deleted (free memory)
+// The list itself also needs to be deleted (free all memory) and set to NULL
+
+int mylist_size( list_pt list )
+{
+	int size = -1;
+	list_errno = mylist_size_r(list, &size);
+	return size;
 }
 // Returns the number of elements in 'list'.
 
 list_pt mylist_insert_at_index( list_pt list, list_elm_pt element, int index)
-{	
-	list_node_pt new_node;
-	int i;
-	
-	list_errno = LIST_NO_ERROR;	
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return NULL;	
-	}		
-	new_node = (list_node_pt)malloc(sizeof(list_node_t));
-	if(new_node == NULL)
-	{
-		DEBUG_PRINT( "DEBUG:: Error in allocating a new list_node\n" );
-		list_errno = LIST_MEMORY_ERROR;
-		return NULL;
-	}		
-	//new_node->element = element; //Deep copy???	
-	list->element_copy(&(new_node->element), element); //make a deep copy
-	
-	//the list node is inserted at the start of 'list'
-	if(index <= 0)
-	{		
-		new_node->prev = NULL;		
-		if(list->num_of_element == 0) //The list is empty
-		{
-			new_node->next = NULL;
-		}
-		else
-		{
-			new_node->next = list->head;
-			list->head->prev = new_node;
-		}		
-		list->head = new_node;		
-	}
-	else
-	{		
-		list_node_pt temp = list->head;		
-		//the list node is inserted at the end of 'list'
-		if(index >= list->num_of_element)
-		{
-			new_node->next = NULL;			
-			for(i=1; i < list->num_of_element; i++)
-			{			
-				temp = temp->next;
-			}			
-			new_node->prev = temp;
-			temp->next = new_node;				
-		}
-		else
-		{
-			//the list node is inserted in the middle of 'list'
-			for(i=1; i < index; i++)
-			{
-				temp = temp->next;
-			}
-			new_node->prev = temp;
-			new_node->next = temp->next;
-			new_node->next->prev = new_node;
-			temp->next = new_node;
-		}		
-	}	
-	
-	list->num_of_element++;
-	return list;
+{
+	list_errno = mylist_insert_at_index_r(list, element, index);
+	return (list_errno == LIST_NO_ERROR) ? list : NULL;
 }
 // Inserts a new list node containing 'element' in 'list' at position 'index'  and returns a pointer to the new list.
 // Remark: the first list node has index 0.
-// If 'index' is 0 or negative, the list node is inserted at the start of 'list'. 
+// If 'index' is 0 or negative, the list node is inserted at the start of 'list'.
 // If 'index' is bigger than the number of elements in 'list', the list node is inserted at the end of 'list'.
-// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR 
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
 
 list_pt mylist_remove_at_index( list_pt list, int index)
-{		
-	list_node_pt temp;
-	
-	list_errno = LIST_NO_ERROR;
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return NULL;	
-	}	
-	//Check the list is empty
-	if(list->num_of_element == 0)
-	{	  
-	  list_errno = LIST_EMPTY_ERROR;
-	  DEBUG_PRINT( "DEBUG:: List is empty\n" );
-	  return list;
-	}	
-	//Check if index is negative or out of list range
-	if(index < 0) index = 0;
-	if(index >= (list->num_of_element)) index = list->num_of_element-1;	
-		
-	temp = mylist_get_reference_at_index(list, index);
-	//If 'index' is 0 or negative, the first list node is removed
-	if(temp->prev == NULL)  
-	{
-		if(temp->next != NULL) temp->next->prev = NULL;
-		list->head = temp->next;
-		//temp->next = NULL;
-		free(temp);
-		list->num_of_element--;	
-		return list;	
-	}	
-	//If 'index' is bigger than the number of elements in 'list', the last list node is removed
-	if(temp->next == NULL)
-	{
-		if(temp->prev != NULL) temp->prev->next = NULL;
-		free(temp);
-		list->num_of_element--;
-		return list;
-	}	
-	//the list node is removed in the middle of 'list'
-	temp->prev->next = temp->next;
-	temp->next->prev = temp->prev;
-	free(temp);	
-	list->num_of_element--;
+{
+	list_errno = mylist_remove_at_index_r(list, index);
 	return list;
 }
-// Removes the list node at index 'index' from 'list'. NO free() is called on the element pointer of the list node. 
-// If 'index' is 0 or negative, the first list node is removed. 
+// Removes the list node at index 'index' from 'list'. NO free() is called on the element pointer of the list node.
+// If 'index' is 0 or negative, the first list node is removed.
 // If 'index' is bigger than the number of elements in 'list', the last list node is removed.
 // If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR (to see the difference with removing the last element from a list)
 
 list_pt mylist_free_at_index( list_pt list, int index)
-{	
-	
-	list_node_pt temp;
-	
-	list_errno = LIST_NO_ERROR;
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return NULL;	
-	}	
-	//Check the list is empty
-	if(list->num_of_element == 0)
-	{	  
-	  list_errno = LIST_EMPTY_ERROR;
-	  DEBUG_PRINT( "DEBUG:: List is empty\n" );
-	  return list;
-	}	
-	//Check if index is negative or out of list range
-	if(index < 0) index = 0;
-	if(index >= (list->num_of_element)) index = list->num_of_element-1;	
-	
-	temp = mylist_get_reference_at_index(list, index);
-	// If 'index' is 0 or negative, the first list node is deleted
-	if(temp->prev == NULL)  
-	{
-		if(temp->next != NULL)	temp->next->prev = NULL;
-		list->head = temp->next;		
-		// list->element_free(temp->element);	// bug found: 11-May-15
-		list->element_free(&(temp->element)); //Fixed bug: 11-May-15
-		free(temp);
-		list->num_of_element--;	
-		return list;	
-	}	
-	//If 'index' is bigger than the number of elements in 'list', the last list node is deleted.
-	if(temp->next == NULL)
-	{
-		if(temp->prev != NULL) temp->prev->next = NULL;
-		// list->element_free(temp->element);	// bug found: 11-May-15
-		list->element_free(&(temp->element)); //Fixed bug: 11-May-15		
-		free(temp);
-		list->num_of_element--;
-		return list;
-	}	
-	//the list node is deleted in the middle of 'list'
-	temp->prev->next = temp->next;
-	temp->next->prev = temp->prev;
-	// list->element_free(temp->element);	// bug found: 11-May-15
-	list->element_free(&(temp->element)); //Fixed bug: 11-May-15
-	free(temp);
-	
-	list->num_of_element--;
+{
+	list_errno = mylist_free_at_index_r(list, index);
 	return list;
 }
-// Deletes the list node at index 'index' in 'list'. 
-// A free() is called on the element pointer of the list node to free any dynamic memory allocated to the element pointer. 
-// If 'index' is 0 or negative, the first list node is deleted. 
+// Deletes the list node at index 'index' in 'list'.
+// A free() is called on the element pointer of the list node to free any dynamic memory allocated to the element pointer.
+// If 'index' is 0 or negative, the first list node is deleted.
 // If 'index' is bigger than the number of elements in 'list', the last list node is deleted.
 // If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR (to see the difference with freeing the last element from a list)
 
 list_node_pt mylist_get_reference_at_index( list_pt list, int index )
-{	
-	int i;
+{
 	list_node_pt node_ptr;
-	
-	list_errno = LIST_NO_ERROR;
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return NULL;	
-	}	
-	//Check the list is empty
-	if(list->num_of_element == 0)
-	{
-	  list_errno = LIST_EMPTY_ERROR;
-	  DEBUG_PRINT( "DEBUG:: List is empty\n" );
-	  return NULL;
-	}	
-	//Check if index is negative or out of list range
-	if(index < 0) index = 0;
-	if(index >= (list->num_of_element)) index = list->num_of_element-1;	
-	node_ptr = list->head;
-	for(i=1; i <= index; i++)
-	{			
-		node_ptr = node_ptr->next; //point to index pos
-	}		
+	list_errno = mylist_get_reference_at_index_r(list, index, &node_ptr);
 	return node_ptr;
 }
-// Returns a reference to the list node with index 'index' in 'list'. 
-// If 'index' is 0 or negative, a reference to the first list node is returned. 
-// If 'index' is bigger than the number of list nodes in 'list', a reference to the last list node is returned. 
+// Returns a reference to the list node with index 'index' in 'list'.
+// If 'index' is 0 or negative, a reference to the first list node is returned.
+// If 'index' is bigger than the number of list nodes in 'list', a reference to the last list node is returned.
 // If the list is empty, NULL is returned.
 
 list_elm_pt mylist_get_element_at_index( list_pt list, int index )
-{	
-	list_errno = LIST_NO_ERROR;	
-	list_node_pt temp = mylist_get_reference_at_index(list, index);
-	if(temp == NULL) return NULL;	
-	return temp->element; //return an element pointer of the list (not a copy)-> be careful!!!
-}
-// Returns the list element contained in the list node with index 'index' in 'list'. 
-// If 'index' is 0 or negative, the element of the first list node is returned. 
+{
+	list_elm_pt element;
+	list_errno = mylist_get_element_at_index_r(list, index, &element);
+	return element;
+}
+// Returns the list element contained in the list node with index 'index' in 'list'.
+// If 'index' is 0 or negative, the element of the first list node is returned.
 // If 'index' is bigger than the number of elements in 'list', the element of the last list node is returned.
 // If the list is empty, NULL is returned.
 
 int mylist_get_index_of_element( list_pt list, list_elm_pt element )
-{		
-	list_errno = LIST_NO_ERROR;
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return -1;	
-	}	
-	//Check the list is empty
-	if(list->num_of_element == 0)
-	{	  
-		list_errno = LIST_EMPTY_ERROR;
-		DEBUG_PRINT( "DEBUG:: List is empty\n" );
-		return -1;
-	}	
-	//Check the element is NULL
-	if(element == NULL)
-	{
-		list_errno = ELEMENT_INVALID_ERROR;
-		DEBUG_PRINT( "DEBUG:: Input element is NULL\n" );
-		return -1;
-	}	
-	int i=0;
-	int isEqual = -1;
-	list_node_pt temp = list->head;
-	while(i < list->num_of_element)
-	{
-		isEqual = list->element_compare(temp->element, element);
-		if(isEqual == 1) return i;
-		temp = temp->next;
-		i++;
-	}	
-	// If 'element' is not found in 'list'
-	return -1;
+{
+	int index;
+	list_errno = mylist_get_index_of_element_r(list, element, &index);
+	return index;
 }
-// Returns an index to the first list node in 'list' containing 'element'.  
+// Returns an index to the first list node in 'list' containing 'element'.
 // If 'element' is not found in 'list', -1 is returned.
 
 void mylist_print( list_pt list )
-{	
-	int i;
-	list_node_pt temp;
-	
-	list_errno = LIST_NO_ERROR;
-	//check if the list is NULL
-	if(list == NULL) 
-	{
-		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-		list_errno = LIST_INVALID_ERROR;
-        return;	
-	}	
-	//Check the list is empty
-	if(list->num_of_element == 0)
+{
+	list_errno = mylist_print_r(list);
+}
+// for testing purposes: print the entire list on screen
+
+list_pt mylist_create_from_array( list_elm_pt array, int num_of_element, int element_size, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print )
+{
+	list_pt mylist;
+	list_errno = mylist_create_from_array_r(&mylist, array, num_of_element, element_size, element_copy, element_free, element_compare, element_print);
+	return mylist;
+}
+// Returns a pointer to a newly-allocated list holding a copy of the 'num_of_element' elements of 'array'.
+// Element i is copied with 'element_copy' from address 'array' + i*'element_size'. All list nodes are allocated in one block.
+// Nodes removed from such a list are kept for its next inserts and freed with the list.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+int mylist_to_array( list_pt list, list_elm_pt array, int size, int element_size )
+{
+	int num_of_copied;
+	list_errno = mylist_to_array_r(list, array, size, element_size, &num_of_copied);
+	return (list_errno == LIST_NO_ERROR) ? num_of_copied : -1;
+}
+// Copies the elements of 'list' in order into 'array' ('element_size' bytes each, at most 'size' elements).
+// Returns the number of copied elements, or -1 if 'list' or 'array' is NULL.
+
+void mylist_set_element_hash( list_pt list, element_hash_func *element_hash )
+{
+	list_errno = mylist_set_element_hash_r(list, element_hash);
+}
+// Sets the (optional) hash callback of 'list'. Elements that compare equal must have the same hash.
+// The set operations below use a hash table when it is set and sort with 'element_compare' otherwise.
+
+list_pt mylist_unique( list_pt list )
+{
+	list_errno = mylist_unique_r(list);
+	return list;
+}
+// Deletes every node whose element compares equal to an element before it in 'list', so the first occurrences remain in their order.
+
+list_pt mylist_intersect( list_pt list, list_pt other )
+{
+	list_errno = mylist_intersect_r(list, other);
+	return list;
+}
+// Deletes every node of 'list' whose element has no equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, nothing is deleted.
+
+list_pt mylist_difference( list_pt list, list_pt other )
+{
+	list_errno = mylist_difference_r(list, other);
+	return list;
+}
+// Deletes every node of 'list' whose element has an equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, all nodes are deleted.
+
+list_pt mylist_union( list_pt list, list_pt other )
+{
+	list_errno = mylist_union_r(list, other);
+	return list;
+}
+// Moves all nodes of 'other' to the end of 'list' ('other' becomes empty), then removes the duplicates like mylist_unique.
+// Both lists must use the same callback functions.
+// If 'other' is 'list' itself, only the duplicates are removed (same as mylist_unique).
+
+list_pt mylist_sort( list_pt list )
+{
+	list_errno = mylist_sort_r(list);
+	return list;
+}
+// Sorts 'list' with 'element_compare'. The sort is stable: equal elements keep their order.
+
+list_pt mylist_sort_parallel( list_pt list, int num_of_threads )
+{
+	list_errno = mylist_sort_parallel_r(list, num_of_threads);
+	return list;
+}
+// Same result as mylist_sort, using 'num_of_threads' threads (the number of processors if 0 or negative).
+
+void mylist_set_lazy_removal( list_pt list, double max_tombstone_ratio )
+{
+	list_errno = mylist_set_lazy_removal_r(list, max_tombstone_ratio);
+}
+// Turns lazy removal on for mylist_remove_element and mylist_free_element when 'max_tombstone_ratio' is above 0:
+// a found node becomes a tombstone and the list is compacted once the tombstones are more than 'max_tombstone_ratio' of all nodes.
+// 0 turns it off (and compacts now), a ratio of 1 or more leaves compaction to mylist_compact and the operations that compact first.
+
+list_pt mylist_remove_element( list_pt list, list_elm_pt element )
+{
+	list_errno = mylist_remove_element_r(list, element);
+	return list;
+}
+// Removes the first list node in 'list' whose element compares equal to 'element'. NO free() is called on the element pointer.
+
+list_pt mylist_free_element( list_pt list, list_elm_pt element )
+{
+	list_errno = mylist_free_element_r(list, element);
+	return list;
+}
+// Deletes the first list node in 'list' whose element compares equal to 'element' and frees its element.
+
+list_pt mylist_compact( list_pt list )
+{
+	list_errno = mylist_compact_r(list);
+	return list;
+}
+// Unlinks the tombstones left by lazy removal and gives their nodes back in one pass.
+
+#ifdef LIST_TRACE
+void mylist_set_trace_hooks( list_trace_hook_func *before, list_trace_hook_func *after, void *arg )
+{
+	trace_before = before;
+	trace_after = after;
+	trace_arg = arg;
+}
+// Sets the hooks called at the start ('before') and at the end ('after') of every operation, NULL for none.
+// 'arg' is passed to both. Must be called while no other thread uses lists.
+
+const char *mylist_trace_op_name( int op )
+{
+	if(op < 0 || op >= LIST_OP_COUNT) return "unknown";
+	return trace_op_names[op];
+}
+// Returns the name of LIST_OP_* 'op' ("insert", "index_of", ...).
+#endif
+
+/*
+ * Public functions - O(1) reference API
+ * 'reference' must be a node of 'list': nothing is checked and list_errno is not touched.
+ * Use the LIST_EXTRA functions for references that may not belong to the list.
+ */
+list_node_pt mylist_get_next_reference( list_node_pt reference )
+{
+	if(reference == NULL) return NULL;
+	do reference = reference->next; while(reference != NULL && LIST_IS_TOMBSTONE(reference));
+	return reference;
+}
+// Returns a reference to the next list node, or NULL at the end of the list. Tombstones are skipped.
+
+list_node_pt mylist_get_previous_reference( list_node_pt reference )
+{
+	if(reference == NULL) return NULL;
+	do reference = reference->prev; while(reference != NULL && LIST_IS_TOMBSTONE(reference));
+	return reference;
+}
+// Returns a reference to the previous list node, or NULL at the start of the list. Tombstones are skipped.
+
+list_elm_pt mylist_get_element_at_reference( list_node_pt reference )
+{
+	return (reference == NULL) ? NULL : reference->element;
+}
+// Returns the element pointer contained in the list node 'reference' (not a copy), or NULL if 'reference' is NULL.
+
+list_pt mylist_move_before_reference( list_pt list, list_node_pt reference, list_node_pt position )
+{
+	if(list == NULL || reference == NULL) return NULL;
+	if(reference == position) return list;
+	list_unlink(list, reference);
+	if(position == NULL)
 	{
-	  //List is empty
-	  list_errno = LIST_EMPTY_ERROR;
-	  DEBUG_PRINT( "DEBUG:: List is empty\n" );
-	  return;
-	}	
-	temp = list->head;
-	for(i=0; i < list->num_of_element; i++)
+		//move to the end of 'list'
+		reference->prev = list->tail;
+		reference->next = NULL;
+		if(list->tail != NULL) list->tail->next = reference;
+		else list->head = reference;
+		list->tail = reference;
+	}
+	else
 	{
-		list->element_print(temp->element);
-		temp = temp->next;
+		reference->prev = position->prev;
+		reference->next = position;
+		if(position->prev != NULL) position->prev->next = reference;
+		else list->head = reference;
+		position->prev = reference;
 	}
+	list->num_of_element++;
+	return list;
 }
-// for testing purposes: print the entire list on screen
+// Moves the list node 'reference' just before the list node 'position' of 'list' (to the end if 'position' is NULL).
+// Moving before the first reference makes it the first node. Returns NULL if 'list' or 'reference' is NULL.
+
+list_pt mylist_remove_at_reference( list_pt list, list_node_pt reference )
+{
+	if(list == NULL || reference == NULL) return NULL;
+	list_unlink(list, reference);
+	list_node_release(list, reference);
+	return list;
+}
+// Removes the list node 'reference' from 'list'. NO free() is called on the element pointer of the list node.
+// Returns NULL if 'list' or 'reference' is NULL.
+
+list_pt mylist_free_at_reference( list_pt list, list_node_pt reference )
+{
+	if(list == NULL || reference == NULL) return NULL;
+	list_unlink(list, reference);
+	LIST_FREE(list->element_free, &(reference->element));
+	list_node_release(list, reference);
+	return list;
+}
+// Deletes the list node 'reference' from 'list' and frees its element with 'element_free'.
+// Returns NULL if 'list' or 'reference' is NULL.
+
+#ifdef LIST_NODE_CACHE
+  void mylist_node_cache_config( int magazine_size, int depot_size )
+  {
+	if(magazine_size > 0) node_cache_magazine_size = magazine_size;
+	if(depot_size >= 0) node_cache_depot_size = depot_size;
+  }
+  // Sets the number of free nodes every thread caches and the number of batches the shared depot keeps.
+  // A value of 0 or negative (-1 for 'depot_size') keeps the current setting.
+  // Must be called before other threads use lists.
+
+  void mylist_node_cache_stats( list_node_cache_stats_t *stats )
+  {
+	pthread_mutex_lock(&node_cache_depot_lock);
+	*stats = node_cache_exited_stats;
+	pthread_mutex_unlock(&node_cache_depot_lock);
+	node_cache_stats_add(stats, &(node_cache_magazine.stats));
+	stats->hit_rate = (stats->alloc_count == 0) ? 0.0 : (double)stats->hit_count / stats->alloc_count;
+  }
+  // Stores the node cache statistics of the calling thread plus those of all threads that already exited in '*stats'.
+
+  void mylist_node_cache_trim( void )
+  {
+	node_magazine_t *magazine = &node_cache_magazine;
+	list_node_pt batch, next;
+
+	while(magazine->top != NULL)
+	{
+		next = magazine->top->next;
+		free(magazine->top);
+		magazine->top = next;
+	}
+	magazine->num_of_node = 0;
+	pthread_mutex_lock(&node_cache_depot_lock);
+	batch = node_cache_depot;
+	__atomic_store_n(&node_cache_depot, (list_node_pt)NULL, __ATOMIC_RELAXED);
+	node_cache_depot_count = 0;
+	pthread_mutex_unlock(&node_cache_depot_lock);
+	while(batch != NULL)
+	{
+		next = batch->prev;
+		while(batch != NULL)
+		{
+			list_node_pt node = batch->next;
+			free(batch);
+			batch = node;
+		}
+		batch = next;
+	}
+  }
+  // Frees the nodes cached by the calling thread and all batches of the shared depot.
+#endif
 
 #ifdef LIST_EXTRA
   list_pt list_insert_at_reference( list_pt list, list_elm_pt element, list_node_pt reference )
@@ -456,32 +2034,29 @@ void mylist_print( list_pt list )
 
   list_pt list_insert_sorted( list_pt list, list_elm_pt element )
   {
-	  int index = 0;
-	  //~ int i,j;
-	  list_errno = LIST_NO_ERROR;	
-		//check if the list is NULL
-		if(list == NULL) 
-		{
-			DEBUG_PRINT( "DEBUG:: List invalid error\n" );
-			list_errno = LIST_INVALID_ERROR;
-			return NULL;	
-		}
-	  list = mylist_insert_at_index(list, element, index);
-	  
-	  // Sort the list
-	  //~ for(i = 0; i < list->num_of_element-1; i++)
-	  //~ {
-		  //~ for(j = i+1; j < list->num_of_element; j++)
-		  //~ {
-			  //~ 
-		  //~ }
-	  //~ }
-	  return list;
+	int index = 0;
+	list_node_pt temp;
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	// Find the first list node that is bigger than 'element' (keeps equal elements in insertion order)
+	for(temp = list->head; temp != NULL; temp = temp->next)
+	{
+		if(LIST_IS_TOMBSTONE(temp)) continue;
+		if(LIST_COMPARE(list, temp->element, element) > 0) break;
+		index++;
+	}
+	return mylist_insert_at_index(list, element, index);
   }
   // Inserts a new list node containing 'element' in the sorted 'list' and returns a pointer to the new list. 
   // The 'list' must be sorted before calling this function. 
   // The sorting is done in ascending order according to a comparison function.  
-  // If two members compare as equal, their order in the sorted array is undefined.
+  // If two members compare as equal, the new element is inserted after the existing ones.
 
   list_pt list_remove_at_reference( list_pt list, list_node_pt reference )
   {		
@@ -513,10 +2088,7 @@ void mylist_print( list_pt list )
 
   list_pt list_remove_element( list_pt list, list_elm_pt element )
   {		
-	int index;	
-	index = mylist_get_index_of_element( list, element );
-	if(index != -1) return mylist_remove_at_index(list, index);	
-	return list;	
+	return mylist_remove_element(list, element);
   }
   // Finds the first list node in 'list' that contains 'element' and removes the list node from 'list'. 
   // NO free() is called on the element pointer of the list node.
@@ -559,7 +2131,7 @@ void mylist_print( list_pt list )
 	// Check If the next element doesn't exists
 	int index = list_get_index_of_reference(list, reference);
 	if(index == -1) return NULL;			
-	return reference->next; 	
+	return mylist_get_next_reference(reference);
   } 
   // Returns a reference to the next list node of the list node with reference 'reference' in 'list'. 
   // If the next element doesn't exists, NULL is returned.
@@ -585,7 +2157,7 @@ void mylist_print( list_pt list )
 	if(reference == NULL) return NULL;	
 	// Check If the next element doesn't exists
 	int index = list_get_index_of_reference(list, reference);
-	if(index != -1){ return reference->prev;}	
+	if(index != -1){ return mylist_get_previous_reference(reference);}	
 	else {	return NULL; }
   }
   // Returns a reference to the previous list node of the list node with reference 'reference' in 'list'. 
@@ -611,7 +2183,7 @@ void mylist_print( list_pt list )
   // If 'element' is not found in 'list', NULL is returned.
 
   int list_get_index_of_reference( list_pt list, list_node_pt reference )
-  {	  lis
+  {
 	list_errno = LIST_NO_ERROR;
 	//check if the list is NULL
 	if(list == NULL) 
@@ -633,8 +2205,9 @@ void mylist_print( list_pt list )
 	}	  
 	int i=0;	
 	list_node_pt temp = list->head;
-	while(i < list->num_of_element)
+	while(temp != NULL)
 	{
+		if(LIST_IS_TOMBSTONE(temp)) { temp = temp->next; continue; }
 		if(temp == reference) return i;		//if 2 pointer point to same node
 		temp = temp->next;
 		i++;
@@ -646,10 +2219,7 @@ void mylist_print( list_pt list )
 
   list_pt list_free_element( list_pt list, list_elm_pt element )
   {		
-	int index;	
-	index = mylist_get_index_of_element( list, element );
-	if(index != -1) return mylist_free_at_index(list, index);	
-	return list;
+	return mylist_free_element(list, element);
   }
   // Finds the first list node in 'list' that contains 'element' and deletes the list node from 'list'. 
   // A free() is called on the element pointer of the list node to free any dynamic memory allocated to the element pointer. 
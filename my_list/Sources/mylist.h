@@ -2,6 +2,9 @@
 #define MYLIST_H_
 
 //#define LIST_EXTRA
+//#define LIST_PARALLEL // use more threads to export and sort lists of at least LIST_PARALLEL_MIN elements (link with -pthread)
+//#define LIST_NODE_CACHE // keep freed list nodes in a per-thread cache instead of calling free() (link with -pthread)
+//#define LIST_TRACE // call trace hooks around every operation, see mylist_set_trace_hooks and mylisttrace.h
 
 extern int list_errno;
 
@@ -22,8 +25,9 @@ typedef list_node_t *list_node_pt;
 //*define CALLBACK function (function pointer)
 typedef void element_copy_func(list_elm_pt *, list_elm_pt);
 typedef void element_free_func(list_elm_pt *);
-typedef int element_compare_func(list_elm_pt, list_elm_pt);
+typedef int element_compare_func(list_elm_pt, list_elm_pt); // three-way compare: <0, 0 (equal) or >0
 typedef void element_print_func(list_elm_pt);
+typedef unsigned long element_hash_func(list_elm_pt); // optional: equal elements must have the same hash
 
 typedef struct list list_t; // list_t is a struct containing at least a head pointer to the start of the list; 
 typedef list_t *list_pt;
@@ -78,6 +82,256 @@ int mylist_get_index_of_element( list_pt list, list_elm_pt element );
 void mylist_print( list_pt list );
 // for testing purposes: print the entire list on screen
 
+list_pt mylist_create_from_array( list_elm_pt array, int num_of_element, int element_size, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a pointer to a newly-allocated list holding a copy of the 'num_of_element' elements of 'array'.
+// Element i is copied with 'element_copy' from address 'array' + i*'element_size'. All list nodes are allocated in one block.
+// Nodes removed from such a list are kept for its next inserts and freed with the list.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+int mylist_to_array( list_pt list, list_elm_pt array, int size, int element_size );
+// Copies the elements of 'list' in order into 'array' ('element_size' bytes each, at most 'size' elements).
+// Returns the number of copied elements, or -1 if 'list' or 'array' is NULL.
+
+void mylist_set_element_hash( list_pt list, element_hash_func *element_hash );
+// Sets the (optional) hash callback of 'list'. Elements that compare equal must have the same hash.
+// The set operations below use a hash table when it is set and sort with 'element_compare' otherwise.
+// They work by unlinking and relinking nodes, no element is copied.
+
+list_pt mylist_unique( list_pt list );
+// Deletes every node whose element compares equal to an element before it in 'list', so the first occurrences remain in their order.
+
+list_pt mylist_intersect( list_pt list, list_pt other );
+// Deletes every node of 'list' whose element has no equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, nothing is deleted.
+
+list_pt mylist_difference( list_pt list, list_pt other );
+// Deletes every node of 'list' whose element has an equal element in 'other'. 'other' is not changed.
+// If 'other' is 'list' itself, all nodes are deleted.
+
+list_pt mylist_union( list_pt list, list_pt other );
+// Moves all nodes of 'other' to the end of 'list' ('other' becomes empty), then removes the duplicates like mylist_unique.
+// Both lists must use the same callback functions.
+// If 'other' is 'list' itself, only the duplicates are removed (same as mylist_unique).
+
+list_pt mylist_sort( list_pt list );
+// Sorts 'list' with 'element_compare' and returns 'list'. The sort is stable: equal elements keep their order.
+// The nodes are relinked, no element is copied.
+
+list_pt mylist_sort_parallel( list_pt list, int num_of_threads );
+// Same result as mylist_sort, using 'num_of_threads' threads (the number of processors if 0 or negative):
+// runs of the list are sorted concurrently on a work-stealing pool and merged by relinking.
+// Without LIST_PARALLEL, or for lists shorter than LIST_PARALLEL_MIN, the calling thread sorts alone.
+
+list_pt mylist_remove_element( list_pt list, list_elm_pt element );
+// Removes the first list node in 'list' whose element compares equal to 'element' (one walk) and returns 'list'.
+// NO free() is called on the element pointer. Nothing is removed if no element is equal.
+// If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
+
+list_pt mylist_free_element( list_pt list, list_elm_pt element );
+// Same as mylist_remove_element, but the element is freed with 'element_free'.
+
+void mylist_set_lazy_removal( list_pt list, double max_tombstone_ratio );
+// Turns lazy removal on for mylist_remove_element and mylist_free_element when 'max_tombstone_ratio' is above 0:
+// a found node is only marked as a tombstone (its element is freed right away by mylist_free_element) and stays
+// linked until the tombstones are more than 'max_tombstone_ratio' of all nodes; then all of them are unlinked
+// and their nodes given back in one pass. Walks and indexes skip tombstones.
+// 0 turns it off (and compacts now), a ratio of 1 or more leaves compaction to mylist_compact and to
+// unique, intersect, difference, union and sort, which compact first.
+
+list_pt mylist_compact( list_pt list );
+// Unlinks the tombstones left by lazy removal and gives their nodes back in one pass. Returns 'list'.
+
+/*
+ * O(1) reference API
+ * 'reference' must be a node of 'list': nothing is checked and list_errno is not touched.
+ * Use the LIST_EXTRA functions for references that may not belong to the list.
+ */
+
+list_node_pt mylist_get_next_reference( list_node_pt reference );
+// Returns a reference to the next list node, or NULL at the end of the list.
+
+list_node_pt mylist_get_previous_reference( list_node_pt reference );
+// Returns a reference to the previous list node, or NULL at the start of the list.
+
+list_elm_pt mylist_get_element_at_reference( list_node_pt reference );
+// Returns the element pointer contained in the list node 'reference' (not a copy), or NULL if 'reference' is NULL.
+
+list_pt mylist_move_before_reference( list_pt list, list_node_pt reference, list_node_pt position );
+// Moves the list node 'reference' just before the list node 'position' of 'list' (to the end if 'position' is NULL).
+// Moving before the first reference makes it the first node. Returns NULL if 'list' or 'reference' is NULL.
+
+list_pt mylist_remove_at_reference( list_pt list, list_node_pt reference );
+// Removes the list node 'reference' from 'list'. NO free() is called on the element pointer of the list node.
+// Returns NULL if 'list' or 'reference' is NULL.
+
+list_pt mylist_free_at_reference( list_pt list, list_node_pt reference );
+// Deletes the list node 'reference' from 'list' and frees its element with 'element_free'.
+// Returns NULL if 'list' or 'reference' is NULL.
+
+/*
+ * Status returning API
+ * The functions below return LIST_NO_ERROR or one of the error codes above and never write list_errno:
+ * results are passed back through the last (pointer) argument. Read-only calls (size, get, index_of, print)
+ * do not write any shared state, so several threads can read the same list concurrently.
+ * The functions above are wrappers around these that copy the returned code into list_errno.
+ */
+
+int mylist_create_r( list_pt *list, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print );
+// Stores a pointer to a newly-allocated list in '*list'.
+// Returns LIST_MEMORY_ERROR and stores NULL if memory allocation failed.
+
+int mylist_free_r( list_pt *list );
+// Every list node and node element of the list is deleted and '*list' is set to NULL.
+// Returns LIST_INVALID_ERROR if 'list' or '*list' is NULL.
+
+int mylist_size_r( list_pt list, int *size );
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_insert_at_index_r( list_pt list, list_elm_pt element, int index );
+// Inserts a new list node containing 'element' in 'list' at position 'index' (same clamping as mylist_insert_at_index).
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_MEMORY_ERROR if memory allocation failed.
+
+int mylist_remove_at_index_r( list_pt list, int index );
+// Removes the list node at index 'index' from 'list' (same clamping as mylist_remove_at_index). NO free() is called on the element pointer.
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_EMPTY_ERROR if 'list' is empty.
+
+int mylist_free_at_index_r( list_pt list, int index );
+// Deletes the list node at index 'index' in 'list' and frees its element (same clamping as mylist_free_at_index).
+// Returns LIST_INVALID_ERROR if 'list' is NULL or LIST_EMPTY_ERROR if 'list' is empty.
+
+int mylist_get_reference_at_index_r( list_pt list, int index, list_node_pt *reference );
+// Stores a reference to the list node with index 'index' in '*reference' (same clamping as mylist_get_reference_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+int mylist_get_element_at_index_r( list_pt list, int index, list_elm_pt *element );
+// Stores the element contained in the list node with index 'index' in '*element' (same clamping as mylist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+int mylist_get_index_of_element_r( list_pt list, list_elm_pt element, int *index );
+// Stores the index of the first list node in 'list' containing 'element' in '*index', or -1 if 'element' is not found.
+// Returns LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mylist_print_r( list_pt list );
+// for testing purposes: print the entire list on screen
+// Returns LIST_INVALID_ERROR or LIST_EMPTY_ERROR on error.
+
+int mylist_create_from_array_r( list_pt *list, list_elm_pt array, int num_of_element, int element_size, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print );
+// Stores a pointer to a newly-allocated list holding a copy of the 'num_of_element' elements of 'array' in '*list'.
+// Element i is copied with 'element_copy' from address 'array' + i*'element_size'.
+// Returns ELEMENT_INVALID_ERROR if 'array' is NULL or LIST_MEMORY_ERROR if memory allocation failed; NULL is stored then.
+
+int mylist_to_array_r( list_pt list, list_elm_pt array, int size, int element_size, int *num_of_copied );
+// Copies the elements of 'list' in order into the caller buffer 'array' in a single traversal ('element_size' bytes each, at most 'size' elements).
+// The number of copied elements is stored in '*num_of_copied'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL or ELEMENT_INVALID_ERROR if 'array' is NULL.
+
+int mylist_set_element_hash_r( list_pt list, element_hash_func *element_hash );
+// Same as mylist_set_element_hash. Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_unique_r( list_pt list );
+int mylist_intersect_r( list_pt list, list_pt other );
+int mylist_difference_r( list_pt list, list_pt other );
+int mylist_union_r( list_pt list, list_pt other );
+// Same as mylist_unique, mylist_intersect, mylist_difference and mylist_union.
+// Return LIST_INVALID_ERROR if a list is NULL or LIST_MEMORY_ERROR if memory allocation failed.
+// After a memory error 'list' is unchanged, except for mylist_union_r where the nodes of 'other' are already moved.
+
+int mylist_sort_r( list_pt list );
+int mylist_sort_parallel_r( list_pt list, int num_of_threads );
+// Same as mylist_sort and mylist_sort_parallel. Return LIST_INVALID_ERROR if 'list' is NULL.
+// If memory for the tasks can't be allocated, mylist_sort_parallel_r sorts on the calling thread.
+
+int mylist_remove_element_r( list_pt list, list_elm_pt element );
+int mylist_free_element_r( list_pt list, list_elm_pt element );
+// Same as mylist_remove_element and mylist_free_element.
+// Return LIST_INVALID_ERROR, LIST_EMPTY_ERROR or ELEMENT_INVALID_ERROR on error.
+
+int mylist_compact_r( list_pt list );
+// Same as mylist_compact. Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mylist_set_lazy_removal_r( list_pt list, double max_tombstone_ratio );
+// Same as mylist_set_lazy_removal. Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+#ifdef LIST_NODE_CACHE
+  /*
+   * Per-thread node cache: nodes freed by remove/free functions are kept by the calling thread and handed
+   * back on its next insert. Overflow goes to a shared depot in batches and is taken back from there.
+   */
+  typedef struct list_node_cache_stats {
+	long alloc_count;     // nodes requested by inserts
+	long hit_count;       // requests served from the cache
+	long release_count;   // nodes given back by removes
+	long depot_get_count; // batches taken from the shared depot
+	long depot_put_count; // batches given to the shared depot
+	long free_count;      // nodes freed because the depot was full
+	double hit_rate;      // hit_count / alloc_count
+  } list_node_cache_stats_t;
+
+  void mylist_node_cache_config( int magazine_size, int depot_size );
+  // Sets the number of free nodes every thread caches and the number of batches the shared depot keeps.
+  // A value of 0 or negative (-1 for 'depot_size') keeps the current setting.
+  // Must be called before other threads use lists.
+
+  void mylist_node_cache_stats( list_node_cache_stats_t *stats );
+  // Stores the node cache statistics of the calling thread plus those of all threads that already exited in '*stats'.
+
+  void mylist_node_cache_trim( void );
+  // Frees the nodes cached by the calling thread and all batches of the shared depot.
+#endif
+
+#ifdef LIST_TRACE
+  /*
+   * Trace hooks: every status returning function (and so every list_errno wrapper) reports one event.
+   * Calls made inside a traced call (mylist_union_r calling mylist_unique_r) are part of the outer event.
+   * Times are in nanoseconds (CLOCK_MONOTONIC), or in TSC ticks if LIST_TRACE_TSC is defined as well.
+   * Without LIST_TRACE the hooks are compiled out, with LIST_TRACE but no hooks set they cost a few thread-local tests per operation.
+   */
+  #define LIST_OP_CREATE 0
+  #define LIST_OP_FREE 1
+  #define LIST_OP_SIZE 2
+  #define LIST_OP_INSERT 3
+  #define LIST_OP_REMOVE 4
+  #define LIST_OP_FREE_AT 5
+  #define LIST_OP_GET_REFERENCE 6
+  #define LIST_OP_GET_ELEMENT 7
+  #define LIST_OP_INDEX_OF 8
+  #define LIST_OP_PRINT 9
+  #define LIST_OP_CREATE_FROM_ARRAY 10
+  #define LIST_OP_TO_ARRAY 11
+  #define LIST_OP_UNIQUE 12
+  #define LIST_OP_INTERSECT 13
+  #define LIST_OP_DIFFERENCE 14
+  #define LIST_OP_UNION 15
+  #define LIST_OP_SORT 16
+  #define LIST_OP_SORT_PARALLEL 17
+  #define LIST_OP_REMOVE_ELEMENT 18
+  #define LIST_OP_FREE_ELEMENT 19
+  #define LIST_OP_COMPACT 20
+  #define LIST_OP_COUNT 21
+
+  typedef struct list_trace_event {
+	int op;                            // LIST_OP_*
+	list_pt list;                      // the list operated on (NULL for create), only an identifier after free
+	int index;                         // requested index, -1 if the operation has none
+	long num_of_node;                  // list nodes traversed
+	long num_of_callback;              // element_copy, element_free and element_compare calls
+	unsigned long long callback_time;  // time spent in those callbacks
+	unsigned long long start;          // clock at the start of the operation
+	unsigned long long elapsed;        // set for the 'after' hook only
+  } list_trace_event_t;
+
+  typedef void list_trace_hook_func(const list_trace_event_t *event, void *arg);
+
+  void mylist_set_trace_hooks( list_trace_hook_func *before, list_trace_hook_func *after, void *arg );
+  // Sets the hooks called at the start ('before') and at the end ('after') of every operation, NULL for none.
+  // 'arg' is passed to both. Must be called while no other thread uses lists.
+  // Callbacks called by the worker threads of mylist_sort_parallel are not counted.
+
+  const char *mylist_trace_op_name( int op );
+  // Returns the name of LIST_OP_* 'op' ("insert", "index_of", ...).
+#endif
+
 #ifdef LIST_EXTRA
   list_pt list_insert_at_reference( list_pt list, list_elm_pt element, list_node_pt reference );
   // Inserts a new list node containing 'element' in the 'list' at position 'reference'  and returns a pointer to the new list. 
@@ -87,7 +341,8 @@ void mylist_print( list_pt list );
   // Inserts a new list node containing 'element' in the sorted 'list' and returns a pointer to the new list. 
   // The 'list' must be sorted before calling this function. 
   // The sorting is done in ascending order according to a comparison function.  
-  // If two members compare as equal, their order in the sorted array is undefined.
+  // If two members compare as equal, the new element is inserted after the existing ones.
+  // For large sorted collections use mysortedlist.h, which does this in O(log n).
 
   list_pt list_remove_at_reference( list_pt list, list_node_pt reference );
   // Removes the list node with reference 'reference' in 'list'. 
@@ -104,6 +359,7 @@ void mylist_print( list_pt list );
   list_pt list_remove_element( list_pt list, list_elm_pt element );
   // Finds the first list node in 'list' that contains 'element' and removes the list node from 'list'. 
   // NO free() is called on the element pointer of the list node.
+  // Same as mylist_remove_element, so lazy removal applies (see mylist_set_lazy_removal).
   // If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
   
   list_node_pt list_get_first_reference( list_pt list );
@@ -137,6 +393,7 @@ void mylist_print( list_pt list );
   list_pt list_free_element( list_pt list, list_elm_pt element );
   // Finds the first list node in 'list' that contains 'element' and deletes the list node from 'list'. 
   // A free() is called on the element pointer of the list node to free any dynamic memory allocated to the element pointer.  
+  // Same as mylist_free_element, so lazy removal applies (see mylist_set_lazy_removal).
 #endif
 
 #endif  //MYLIST_H_
@@ -0,0 +1,446 @@
+/*
+ ============================================================================
+ Name        : mylistcache.cpp
+ Author      : cph
+ Version     : 1.0
+ Copyright   : Copyright from Chi Pham Hoang
+ Description : Implementation of an LRU/LFU cache on top of mylist
+ 	 	 	   Dynamic memory
+ Note 	     : 1) The cached elements are the nodes of a mylist, the next
+ 	 	 	   one to be evicted is always the last node.
+ 	 	 	   2) An open-addressing hash table maps every element to its
+ 	 	 	   list node, so a hit is a hash lookup plus one relink.
+			   3) User must implement 5 functions to work with this API:
+			   - A copy function: to copy an element into the cache
+			   - A free function: to free an evicted element
+			   - A compare function; to compare 2 elements in the cache
+			   - A hash function: equal elements must have the same hash
+			   - A print function: to print out an element to stdout
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "mylistcache.h"
+
+#ifdef DEBUG
+	#define DEBUG_PRINT(...) 															\
+	  do {					  															\
+		printf("In %s - function %s at line %d: ", __FILE__, __func__, __LINE__);		\
+		printf(__VA_ARGS__);															\
+	  } while(0)
+#else
+	#define DEBUG_PRINT(...) (void)0
+#endif
+
+#define CACHE_INITIAL_SLOTS 16
+
+/*
+ * The real definition of 'struct list_cache'
+ */
+typedef struct cache_group {
+	long freq;                 // hit count of every node in the group (LFU)
+	list_node_pt head;         // first (most recent) node of the group, the group is contiguous in the list
+	int num_of_node;
+	struct cache_group *higher; // group with the next higher 'freq', closer to the start of the list
+	struct cache_group *lower;
+} cache_group_t;
+
+typedef struct cache_slot {
+	list_node_pt node;         // NULL for an empty slot
+	unsigned long hash;
+	cache_group_t *group;      // LFU only
+} cache_slot_t;
+
+struct list_cache {
+	list_pt list;              // most valuable element first, evicted from the end
+	cache_slot_t *slots;
+	size_t mask;               // number of slots - 1, the number of slots is a power of 2
+	int num_of_element;
+	cache_group_t *lowest;     // LFU: group of the last nodes of the list
+	int policy;
+	int max_entries;
+	size_t max_bytes;
+	size_t num_of_bytes;
+	element_size_func *element_size; //callback functions
+	element_compare_func *element_compare;
+	element_hash_func *element_hash;
+	list_cache_stats_t stats;
+};
+
+/*
+ * Private functions
+ */
+static cache_slot_t *cache_find( list_cache_pt cache, list_elm_pt element, unsigned long hash )
+{
+	size_t i = hash & cache->mask;
+	while(cache->slots[i].node != NULL)
+	{
+		if(cache->slots[i].hash == hash &&
+		   cache->element_compare(mylist_get_element_at_reference(cache->slots[i].node), element) == 0) return &cache->slots[i];
+		i = (i + 1) & cache->mask;
+	}
+	return NULL;
+}
+// Returns the slot of the cached element equal to 'element', or NULL.
+
+static int cache_grow( list_cache_pt cache )
+{
+	size_t i, j, size = (cache->mask + 1) * 2;
+	cache_slot_t *slots = (cache_slot_t *)calloc(size, sizeof(cache_slot_t));
+	if(slots == NULL) return LIST_MEMORY_ERROR;
+	for(i = 0; i <= cache->mask; i++)
+	{
+		if(cache->slots[i].node == NULL) continue;
+		for(j = cache->slots[i].hash & (size - 1); slots[j].node != NULL; j = (j + 1) & (size - 1));
+		slots[j] = cache->slots[i];
+	}
+	free(cache->slots);
+	cache->slots = slots;
+	cache->mask = size - 1;
+	return LIST_NO_ERROR;
+}
+// Doubles the hash table. Returns LIST_MEMORY_ERROR if memory allocation failed.
+
+static cache_slot_t *cache_slot_add( list_cache_pt cache, list_node_pt node, unsigned long hash )
+{
+	size_t i;
+	if((size_t)(cache->num_of_element + 1) * 2 > cache->mask + 1 && cache_grow(cache) != LIST_NO_ERROR) return NULL;
+	for(i = hash & cache->mask; cache->slots[i].node != NULL; i = (i + 1) & cache->mask);
+	cache->slots[i].node = node;
+	cache->slots[i].hash = hash;
+	cache->slots[i].group = NULL;
+	cache->num_of_element++;
+	return &cache->slots[i];
+}
+// Adds 'node' to the hash table (kept at most half full). Returns NULL if memory allocation failed.
+
+static void cache_slot_remove( list_cache_pt cache, cache_slot_t *slot )
+{
+	size_t i = slot - cache->slots, j = i, home;
+	for(;;)
+	{
+		//backward shift: move up every following entry that may not be found anymore once slot 'i' is empty
+		j = (j + 1) & cache->mask;
+		if(cache->slots[j].node == NULL) break;
+		home = cache->slots[j].hash & cache->mask;
+		if(((j - home) & cache->mask) >= ((j - i) & cache->mask))
+		{
+			cache->slots[i] = cache->slots[j];
+			i = j;
+		}
+	}
+	cache->slots[i].node = NULL;
+	cache->num_of_element--;
+}
+// Deletes 'slot' from the hash table without leaving a tombstone.
+
+static cache_group_t *cache_group_insert( list_cache_pt cache, cache_group_t *lower, cache_group_t *higher, long freq )
+{
+	cache_group_t *group = (cache_group_t *)malloc(sizeof(cache_group_t));
+	if(group == NULL) return NULL;
+	group->freq = freq;
+	group->head = NULL;
+	group->num_of_node = 0;
+	group->lower = lower;
+	group->higher = higher;
+	if(lower != NULL) lower->higher = group;
+	else cache->lowest = group;
+	if(higher != NULL) higher->lower = group;
+	return group;
+}
+// Links a new, empty group with hit count 'freq' between 'lower' and 'higher'. Returns NULL if memory allocation failed.
+
+static void cache_group_leave( list_cache_pt cache, cache_group_t *group, list_node_pt node )
+{
+	if(--group->num_of_node > 0)
+	{
+		if(group->head == node) group->head = mylist_get_next_reference(node);
+		return;
+	}
+	if(group->lower != NULL) group->lower->higher = group->higher;
+	else cache->lowest = group->higher;
+	if(group->higher != NULL) group->higher->lower = group->lower;
+	free(group);
+}
+// Takes 'node' out of 'group' (before 'node' is moved or freed); an empty group is deleted.
+
+static int cache_touch( list_cache_pt cache, cache_slot_t *slot )
+{
+	list_node_pt node = slot->node, first;
+	cache_group_t *group = slot->group, *next;
+	if(cache->policy == LIST_CACHE_LRU)
+	{
+		mylist_get_reference_at_index_r(cache->list, 0, &first);
+		mylist_move_before_reference(cache->list, node, first);
+		return LIST_NO_ERROR;
+	}
+	next = group->higher;
+	if(next == NULL || next->freq != group->freq + 1)
+	{
+		next = cache_group_insert(cache, group, next, group->freq + 1);
+		if(next == NULL) return LIST_MEMORY_ERROR;
+	}
+	cache_group_leave(cache, group, node);
+	//a new group is empty and lies just before the nodes of 'group' (or of the group below if 'group' was deleted)
+	if(next->head == NULL) first = (next->lower != NULL) ? next->lower->head : NULL;
+	else first = next->head;
+	mylist_move_before_reference(cache->list, node, first);
+	next->head = node;
+	next->num_of_node++;
+	slot->group = next;
+	return LIST_NO_ERROR;
+}
+// Marks the element of 'slot' as used: LRU moves it to the front, LFU moves it to the front of the group with one more hit.
+
+static void cache_drop( list_cache_pt cache, cache_slot_t *slot )
+{
+	list_node_pt node = slot->node;
+	if(cache->policy == LIST_CACHE_LFU) cache_group_leave(cache, slot->group, node);
+	if(cache->element_size != NULL) cache->num_of_bytes -= cache->element_size(mylist_get_element_at_reference(node));
+	cache_slot_remove(cache, slot);
+	mylist_free_at_reference(cache->list, node);
+}
+// Deletes the element of 'slot' from the cache and frees it.
+
+static void cache_drop_last( list_cache_pt cache, list_node_pt keep )
+{
+	list_node_pt last;
+	list_elm_pt element;
+	mylist_get_reference_at_index_r(cache->list, INT_MAX, &last);
+	if(last == keep && mylist_get_previous_reference(last) != NULL) last = mylist_get_previous_reference(last);
+	element = mylist_get_element_at_reference(last);
+	cache_drop(cache, cache_find(cache, element, cache->element_hash(element)));
+	cache->stats.evict_count++;
+}
+// Evicts the last element of the list, or the one before it if the last is 'keep'. The cache must not be empty.
+
+/*
+ * Public functions
+ */
+list_cache_pt mylistcache_create( int policy, int max_entries, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_hash_func *element_hash, element_print_func *element_print )
+{
+	list_cache_pt cache = (list_cache_pt)calloc(1, sizeof(list_cache_t));
+	list_errno = LIST_MEMORY_ERROR;
+	if(cache == NULL) return NULL;
+	cache->slots = (cache_slot_t *)calloc(CACHE_INITIAL_SLOTS, sizeof(cache_slot_t));
+	if(cache->slots == NULL || mylist_create_r(&cache->list, element_copy, element_free, element_compare, element_print) != LIST_NO_ERROR)
+	{
+		DEBUG_PRINT("Memory allocation failed\n");
+		free(cache->slots);
+		free(cache);
+		return NULL;
+	}
+	cache->mask = CACHE_INITIAL_SLOTS - 1;
+	cache->policy = (policy == LIST_CACHE_LFU) ? LIST_CACHE_LFU : LIST_CACHE_LRU;
+	cache->max_entries = (max_entries > 0) ? max_entries : 0;
+	cache->element_compare = element_compare;
+	cache->element_hash = element_hash;
+	list_errno = LIST_NO_ERROR;
+	return cache;
+}
+// Returns a pointer to a newly-allocated, empty cache with policy LIST_CACHE_LRU or LIST_CACHE_LFU
+// that holds at most 'max_entries' elements (0 for no limit).
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mylistcache_set_max_bytes( list_cache_pt cache, size_t max_bytes, element_size_func *element_size )
+{
+	list_errno = LIST_INVALID_ERROR;
+	if(cache == NULL || cache->num_of_element > 0) return;
+	cache->max_bytes = max_bytes;
+	cache->element_size = element_size;
+	list_errno = LIST_NO_ERROR;
+}
+// Limits the sum of 'element_size' of the cached elements to 'max_bytes' (0 for no limit).
+// Must be called while the cache is empty.
+
+void mylistcache_free( list_cache_pt *cache )
+{
+	cache_group_t *group, *next;
+	list_errno = LIST_INVALID_ERROR;
+	if(cache == NULL || *cache == NULL) return;
+	for(group = (*cache)->lowest; group != NULL; group = next)
+	{
+		next = group->higher;
+		free(group);
+	}
+	mylist_free_r(&(*cache)->list);
+	free((*cache)->slots);
+	free(*cache);
+	*cache = NULL;
+	list_errno = LIST_NO_ERROR;
+}
+// Every cached element is freed, the cache itself is deleted (free memory) and set to NULL
+
+int mylistcache_size( list_cache_pt cache )
+{
+	if(cache == NULL)
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return -1;
+	}
+	list_errno = LIST_NO_ERROR;
+	return cache->num_of_element;
+}
+// Returns the number of elements in 'cache'.
+
+list_elm_pt mylistcache_get( list_cache_pt cache, list_elm_pt element )
+{
+	cache_slot_t *slot;
+	if(cache == NULL || element == NULL)
+	{
+		list_errno = (cache == NULL) ? LIST_INVALID_ERROR : ELEMENT_INVALID_ERROR;
+		return NULL;
+	}
+	slot = cache_find(cache, element, cache->element_hash(element));
+	if(slot == NULL)
+	{
+		cache->stats.miss_count++;
+		list_errno = LIST_NO_ERROR;
+		return NULL;
+	}
+	cache->stats.hit_count++;
+	list_errno = cache_touch(cache, slot); // LFU may fail to allocate a group: the element is returned anyway
+	return mylist_get_element_at_reference(slot->node);
+}
+// Returns the cached element that compares equal to 'element' (not a copy) and marks it as used, or NULL on a miss.
+
+list_elm_pt mylistcache_peek( list_cache_pt cache, list_elm_pt element )
+{
+	cache_slot_t *slot;
+	if(cache == NULL || element == NULL)
+	{
+		list_errno = (cache == NULL) ? LIST_INVALID_ERROR : ELEMENT_INVALID_ERROR;
+		return NULL;
+	}
+	list_errno = LIST_NO_ERROR;
+	slot = cache_find(cache, element, cache->element_hash(element));
+	return (slot == NULL) ? NULL : mylist_get_element_at_reference(slot->node);
+}
+// Same as mylistcache_get, but the element is not marked as used and the statistics are not updated.
+
+list_cache_pt mylistcache_put( list_cache_pt cache, list_elm_pt element )
+{
+	cache_slot_t *slot, *old;
+	cache_group_t *group = NULL;
+	list_node_pt node, position = NULL;
+	unsigned long hash;
+	if(cache == NULL || element == NULL)
+	{
+		list_errno = (cache == NULL) ? LIST_INVALID_ERROR : ELEMENT_INVALID_ERROR;
+		return NULL;
+	}
+	hash = cache->element_hash(element);
+	//an equal cached element is only dropped once nothing can fail anymore, so a failed put keeps it
+	old = cache_find(cache, element, hash);
+	list_errno = LIST_MEMORY_ERROR;
+	if(cache->policy == LIST_CACHE_LFU)
+	{
+		//a new element has no hits yet: it goes to the front of the lowest group
+		group = cache->lowest;
+		if(group == NULL || group->freq != 0) group = cache_group_insert(cache, NULL, group, 0);
+		if(group == NULL) return NULL;
+		position = group->head;
+	}
+	if(mylist_insert_at_index_r(cache->list, element, INT_MAX) != LIST_NO_ERROR)
+	{
+		if(group != NULL && group->num_of_node == 0) cache_group_leave(cache, group, NULL);
+		return NULL;
+	}
+	mylist_get_reference_at_index_r(cache->list, INT_MAX, &node);
+	slot = (old != NULL) ? old : cache_slot_add(cache, node, hash);
+	if(slot == NULL)
+	{
+		mylist_free_at_reference(cache->list, node);
+		if(group != NULL && group->num_of_node == 0) cache_group_leave(cache, group, NULL);
+		return NULL;
+	}
+	if(group != NULL)
+	{
+		group->head = node;
+		group->num_of_node++;
+	}
+	else
+	{
+		mylist_get_reference_at_index_r(cache->list, 0, &position);
+	}
+	mylist_move_before_reference(cache->list, node, position);
+	if(old != NULL)
+	{
+		//replace the old element in its slot, the hash of equal elements is the same
+		if(cache->policy == LIST_CACHE_LFU) cache_group_leave(cache, old->group, old->node);
+		if(cache->element_size != NULL) cache->num_of_bytes -= cache->element_size(mylist_get_element_at_reference(old->node));
+		mylist_free_at_reference(cache->list, old->node);
+		old->node = node;
+	}
+	slot->group = group;
+	if(cache->element_size != NULL) cache->num_of_bytes += cache->element_size(mylist_get_element_at_reference(node));
+	cache->stats.insert_count++;
+	//the new element has the lowest hit count (LFU), so it is evicted only when nothing else is left
+	while(cache->num_of_element > 0 &&
+		  ((cache->max_entries > 0 && cache->num_of_element > cache->max_entries) ||
+		   (cache->max_bytes > 0 && cache->num_of_bytes > cache->max_bytes))) cache_drop_last(cache, node);
+	list_errno = LIST_NO_ERROR;
+	return cache;
+}
+// Puts a copy of 'element' in 'cache' as the most recently used element and returns 'cache'.
+// An equal element that is already cached is replaced (freed). Other elements are evicted until the limits are met;
+// the new element itself is only evicted if it alone exceeds them.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR; a cached equal element is then kept
+
+list_cache_pt mylistcache_erase( list_cache_pt cache, list_elm_pt element )
+{
+	cache_slot_t *slot;
+	if(cache == NULL || element == NULL)
+	{
+		list_errno = (cache == NULL) ? LIST_INVALID_ERROR : ELEMENT_INVALID_ERROR;
+		return NULL;
+	}
+	slot = cache_find(cache, element, cache->element_hash(element));
+	if(slot != NULL) cache_drop(cache, slot);
+	list_errno = LIST_NO_ERROR;
+	return cache;
+}
+// Deletes the cached element that compares equal to 'element', if any, and returns 'cache'.
+
+list_cache_pt mylistcache_evict( list_cache_pt cache )
+{
+	if(cache == NULL)
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	if(cache->num_of_element == 0)
+	{
+		list_errno = LIST_EMPTY_ERROR;
+		return cache;
+	}
+	cache_drop_last(cache, NULL);
+	list_errno = LIST_NO_ERROR;
+	return cache;
+}
+// Deletes the element that would be evicted next (least recently used or least frequently used) and returns 'cache'.
+// If the cache is empty, return cache and list_errno is set to LIST_EMPTY_ERROR
+
+void mylistcache_stats( list_cache_pt cache, list_cache_stats_t *stats )
+{
+	list_errno = LIST_INVALID_ERROR;
+	if(cache == NULL || stats == NULL) return;
+	*stats = cache->stats;
+	list_errno = LIST_NO_ERROR;
+}
+// Stores the hit, miss, insert and evict counts of 'cache' in '*stats'.
+
+void mylistcache_print( list_cache_pt cache )
+{
+	if(cache == NULL)
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	printf("cache: %d elements, %ld hits, %ld misses, %ld evictions\n", cache->num_of_element,
+		   cache->stats.hit_count, cache->stats.miss_count, cache->stats.evict_count);
+	list_errno = mylist_print_r(cache->list);
+}
+// for testing purposes: print the cached elements on screen, the next one to be evicted last
@@ -0,0 +1,74 @@
+#ifndef MYLISTCACHE_H_
+#define MYLISTCACHE_H_
+
+#include <stddef.h>
+#include "mylist.h"
+
+/*
+ * LRU/LFU cache built on mylist: the list holds the cached elements with the most valuable one first and
+ * a hash table maps every element to its list node, so get/put/evict never walk the list.
+ * LRU: a hit moves the node to the front, the last node is evicted.
+ * LFU: the list is kept in groups of equal hit count (highest count first, most recent first within a group),
+ *      a hit moves the node to the front of the next group, the last node is evicted.
+ * Elements are looked up with 'element_hash' and 'element_compare' (equal elements must have the same hash),
+ * so for a key/value cache the callbacks only look at the key part of the element.
+ * Evicted and replaced elements are freed with 'element_free'.
+ * Errors are reported through list_errno with the same codes as mylist.
+ */
+
+#define LIST_CACHE_LRU 0
+#define LIST_CACHE_LFU 1
+
+typedef size_t element_size_func(list_elm_pt); // number of bytes an element accounts for
+
+typedef struct list_cache list_cache_t;
+typedef list_cache_t *list_cache_pt;
+
+typedef struct list_cache_stats {
+	long hit_count;
+	long miss_count;
+	long insert_count;
+	long evict_count;
+} list_cache_stats_t;
+
+list_cache_pt mylistcache_create( int policy, int max_entries, element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_hash_func *element_hash, element_print_func *element_print );
+// Returns a pointer to a newly-allocated, empty cache with policy LIST_CACHE_LRU or LIST_CACHE_LFU
+// that holds at most 'max_entries' elements (0 for no limit).
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mylistcache_set_max_bytes( list_cache_pt cache, size_t max_bytes, element_size_func *element_size );
+// Limits the sum of 'element_size' of the cached elements to 'max_bytes' (0 for no limit).
+// Must be called while the cache is empty.
+
+void mylistcache_free( list_cache_pt *cache );
+// Every cached element is freed, the cache itself is deleted (free memory) and set to NULL
+
+int mylistcache_size( list_cache_pt cache );
+// Returns the number of elements in 'cache'.
+
+list_elm_pt mylistcache_get( list_cache_pt cache, list_elm_pt element );
+// Returns the cached element that compares equal to 'element' (not a copy) and marks it as used, or NULL on a miss.
+
+list_elm_pt mylistcache_peek( list_cache_pt cache, list_elm_pt element );
+// Same as mylistcache_get, but the element is not marked as used and the statistics are not updated.
+
+list_cache_pt mylistcache_put( list_cache_pt cache, list_elm_pt element );
+// Puts a copy of 'element' in 'cache' as the most recently used element and returns 'cache'.
+// An equal element that is already cached is replaced (freed). Other elements are evicted until the limits are met;
+// the new element itself is only evicted if it alone exceeds them.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR; a cached equal element is then kept
+
+list_cache_pt mylistcache_erase( list_cache_pt cache, list_elm_pt element );
+// Deletes the cached element that compares equal to 'element', if any, and returns 'cache'.
+
+list_cache_pt mylistcache_evict( list_cache_pt cache );
+// Deletes the element that would be evicted next (least recently used or least frequently used) and returns 'cache'.
+// If the cache is empty, return cache and list_errno is set to LIST_EMPTY_ERROR
+
+void mylistcache_stats( list_cache_pt cache, list_cache_stats_t *stats );
+// Stores the hit, miss, insert and evict counts of 'cache' in '*stats'.
+
+void mylistcache_print( list_cache_pt cache );
+// for testing purposes: print the cached elements on screen, the next one to be evicted last
+
+#endif  //MYLISTCACHE_H_
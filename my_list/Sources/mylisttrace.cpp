@@ -0,0 +1,315 @@
+/*
+ ============================================================================
+ Name        : mylisttrace.cpp
+ Author      : cph
+ Version     : 1.0
+ Copyright   : Copyright from Chi Pham Hoang
+ Description : Implementation of a latency collector for the mylist
+ 	 	 	   trace hooks
+ Note 	     : 1) Only built with LIST_TRACE, like the hooks themselves.
+ 	 	 	   2) Histograms use log-linear buckets: values below 32 are
+ 	 	 	   exact, above that every power of 2 is cut in 32 buckets.
+ 	 	 	   3) The last 'max_events' events are kept in a ring for
+ 	 	 	   the Chrome trace-event export.
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mylisttrace.h"
+
+#ifdef LIST_TRACE
+
+#ifdef DEBUG
+	#define DEBUG_PRINT(...) 															\
+	  do {					  															\
+		printf("In %s - function %s at line %d: ", __FILE__, __func__, __LINE__);		\
+		printf(__VA_ARGS__);															\
+	  } while(0)
+#else
+	#define DEBUG_PRINT(...) (void)0
+#endif
+
+#define TRACE_SUB_BITS 5
+#define TRACE_SUB_BUCKETS (1 << TRACE_SUB_BITS)
+#define TRACE_BUCKETS ((64 - TRACE_SUB_BITS + 1) * TRACE_SUB_BUCKETS)
+
+/*
+ * The real definition of 'struct list_trace_collector'
+ */
+typedef struct trace_histogram {
+	long count;
+	unsigned long long max;
+	unsigned long long sum_callback_time;
+	long long sum_num_of_node;
+	long bucket[TRACE_BUCKETS];
+} trace_histogram_t;
+
+typedef struct trace_record {
+	list_trace_event_t event;
+	int thread;
+} trace_record_t;
+
+struct list_trace_collector {
+	pthread_mutex_t lock;
+	trace_histogram_t histogram[LIST_OP_COUNT];
+	trace_record_t *events; // ring of the last 'max_events' events
+	int max_events;
+	long num_of_event;      // events ever put in the ring
+};
+
+static int trace_next_thread = 0;
+static thread_local int trace_thread = -1; // small id of the calling thread for the Chrome trace
+
+/*
+ * Private functions
+ */
+static int trace_bucket( unsigned long long value )
+{
+	int k;
+	if(value < TRACE_SUB_BUCKETS) return (int)value;
+	k = 63 - __builtin_clzll(value); // k >= TRACE_SUB_BITS
+	return (k - TRACE_SUB_BITS + 1)*TRACE_SUB_BUCKETS + (int)(value >> (k - TRACE_SUB_BITS)) - TRACE_SUB_BUCKETS;
+}
+// Returns the histogram bucket of 'value'.
+
+static unsigned long long trace_bucket_value( int bucket )
+{
+	int k, sub;
+	if(bucket < TRACE_SUB_BUCKETS) return bucket;
+	k = bucket/TRACE_SUB_BUCKETS + TRACE_SUB_BITS - 1;
+	sub = bucket%TRACE_SUB_BUCKETS;
+	return ((unsigned long long)(TRACE_SUB_BUCKETS + sub + 1) << (k - TRACE_SUB_BITS)) - 1;
+}
+// Returns the highest value that falls in 'bucket'.
+
+static void trace_hook( const list_trace_event_t *event, void *arg )
+{
+	mylisttrace_record((list_trace_collector_pt)arg, event);
+}
+
+/*
+ * Public functions
+ */
+list_trace_collector_pt mylisttrace_create( int max_events )
+{
+	list_trace_collector_pt collector = (list_trace_collector_pt)calloc(1, sizeof(list_trace_collector_t));
+	list_errno = LIST_MEMORY_ERROR;
+	if(collector == NULL) return NULL;
+	collector->max_events = (max_events > 0) ? max_events : 0;
+	if(collector->max_events > 0)
+	{
+		collector->events = (trace_record_t *)malloc(collector->max_events * sizeof(trace_record_t));
+		if(collector->events == NULL)
+		{
+			DEBUG_PRINT("Memory allocation failed\n");
+			free(collector);
+			return NULL;
+		}
+	}
+	pthread_mutex_init(&collector->lock, NULL);
+	list_errno = LIST_NO_ERROR;
+	return collector;
+}
+// Returns a pointer to a newly-allocated, empty collector that keeps the last 'max_events' events for
+// mylisttrace_dump_chrome (0 to keep histograms only).
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mylisttrace_free( list_trace_collector_pt *collector )
+{
+	list_errno = LIST_INVALID_ERROR;
+	if(collector == NULL || *collector == NULL) return;
+	pthread_mutex_destroy(&(*collector)->lock);
+	free((*collector)->events);
+	free(*collector);
+	*collector = NULL;
+	list_errno = LIST_NO_ERROR;
+}
+// The collector is deleted (free memory) and set to NULL. Detach it first if it is attached.
+
+void mylisttrace_attach( list_trace_collector_pt collector )
+{
+	mylist_set_trace_hooks(NULL, (collector == NULL) ? NULL : trace_hook, collector);
+}
+// Installs 'collector' as the 'after' trace hook of mylist (see mylist_set_trace_hooks).
+
+void mylisttrace_detach( void )
+{
+	mylist_set_trace_hooks(NULL, NULL, NULL);
+}
+// Removes the trace hooks of mylist.
+
+void mylisttrace_record( list_trace_collector_pt collector, const list_trace_event_t *event )
+{
+	trace_histogram_t *histogram;
+	trace_record_t *record;
+	if(collector == NULL || event == NULL || event->op < 0 || event->op >= LIST_OP_COUNT) return;
+	if(trace_thread < 0) trace_thread = __atomic_fetch_add(&trace_next_thread, 1, __ATOMIC_RELAXED);
+	pthread_mutex_lock(&collector->lock);
+	histogram = &collector->histogram[event->op];
+	histogram->count++;
+	histogram->bucket[trace_bucket(event->elapsed)]++;
+	if(event->elapsed > histogram->max) histogram->max = event->elapsed;
+	histogram->sum_callback_time += event->callback_time;
+	histogram->sum_num_of_node += event->num_of_node;
+	if(collector->max_events > 0)
+	{
+		record = &collector->events[collector->num_of_event % collector->max_events];
+		record->event = *event;
+		record->thread = trace_thread;
+		collector->num_of_event++;
+	}
+	pthread_mutex_unlock(&collector->lock);
+}
+// Adds 'event' to 'collector'. For use in an own hook that also does something else.
+
+void mylisttrace_reset( list_trace_collector_pt collector )
+{
+	int i, j;
+	if(collector == NULL) return;
+	pthread_mutex_lock(&collector->lock);
+	for(i = 0; i < LIST_OP_COUNT; i++)
+	{
+		collector->histogram[i].count = 0;
+		collector->histogram[i].max = 0;
+		collector->histogram[i].sum_callback_time = 0;
+		collector->histogram[i].sum_num_of_node = 0;
+		for(j = 0; j < TRACE_BUCKETS; j++) collector->histogram[i].bucket[j] = 0;
+	}
+	collector->num_of_event = 0;
+	pthread_mutex_unlock(&collector->lock);
+}
+// Forgets all recorded events.
+
+long mylisttrace_count( list_trace_collector_pt collector, int op )
+{
+	long count = 0;
+	int i;
+	if(collector == NULL || op < -1 || op >= LIST_OP_COUNT) return 0;
+	pthread_mutex_lock(&collector->lock);
+	for(i = 0; i < LIST_OP_COUNT; i++)
+	{
+		if(op == -1 || op == i) count += collector->histogram[i].count;
+	}
+	pthread_mutex_unlock(&collector->lock);
+	return count;
+}
+// Returns the number of recorded events of LIST_OP_* 'op', or of all operations if 'op' is -1.
+
+static unsigned long long trace_percentile( const trace_histogram_t *histogram, int op, double percentile )
+{
+	unsigned long long value = 0, max = 0;
+	long count = 0, rank, seen = 0;
+	int i, j;
+	if(percentile < 0) percentile = 0;
+	if(percentile > 100) percentile = 100;
+	for(i = 0; i < LIST_OP_COUNT; i++)
+	{
+		if(op != -1 && op != i) continue;
+		count += histogram[i].count;
+		if(histogram[i].max > max) max = histogram[i].max;
+	}
+	if(count > 0)
+	{
+		//the smallest bucket that holds at least 'percentile' % of the events
+		rank = (long)(percentile/100.0*count + 0.5);
+		if(rank < 1) rank = 1;
+		for(j = 0; j < TRACE_BUCKETS && seen < rank; j++)
+		{
+			for(i = 0; i < LIST_OP_COUNT; i++)
+			{
+				if(op == -1 || op == i) seen += histogram[i].bucket[j];
+			}
+			value = trace_bucket_value(j);
+		}
+		if(value > max) value = max;
+	}
+	return value;
+}
+// Same as mylisttrace_percentile on the LIST_OP_COUNT histograms 'histogram'. The caller holds the lock or owns a copy.
+
+unsigned long long mylisttrace_percentile( list_trace_collector_pt collector, int op, double percentile )
+{
+	unsigned long long value;
+	if(collector == NULL || op < -1 || op >= LIST_OP_COUNT) return 0;
+	pthread_mutex_lock(&collector->lock);
+	value = trace_percentile(collector->histogram, op, percentile);
+	pthread_mutex_unlock(&collector->lock);
+	return value;
+}
+// Returns the elapsed time below which 'percentile' % (0 to 100) of the events of 'op' (-1 for all) fall.
+// Returns 0 if there are no such events.
+
+void mylisttrace_print( list_trace_collector_pt collector )
+{
+	trace_histogram_t *histogram;
+	int i;
+	if(collector == NULL)
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	//one snapshot under the lock, so every row is consistent while other threads keep recording
+	histogram = (trace_histogram_t *)malloc(LIST_OP_COUNT * sizeof(trace_histogram_t));
+	if(histogram == NULL)
+	{
+		list_errno = LIST_MEMORY_ERROR;
+		return;
+	}
+	pthread_mutex_lock(&collector->lock);
+	memcpy(histogram, collector->histogram, LIST_OP_COUNT * sizeof(trace_histogram_t));
+	pthread_mutex_unlock(&collector->lock);
+	printf("%-18s %10s %10s %10s %10s %10s %10s %8s %10s\n", "operation", "count", "p50", "p90", "p99", "p99.9", "max", "nodes", "callback");
+	for(i = 0; i < LIST_OP_COUNT; i++)
+	{
+		if(histogram[i].count == 0) continue;
+		printf("%-18s %10ld %10llu %10llu %10llu %10llu %10llu %8.1f %10.1f\n", mylist_trace_op_name(i), histogram[i].count,
+			   trace_percentile(histogram, i, 50), trace_percentile(histogram, i, 90),
+			   trace_percentile(histogram, i, 99), trace_percentile(histogram, i, 99.9), histogram[i].max,
+			   (double)histogram[i].sum_num_of_node/histogram[i].count, (double)histogram[i].sum_callback_time/histogram[i].count);
+	}
+	free(histogram);
+	list_errno = LIST_NO_ERROR;
+}
+// Prints a table with count, p50, p90, p99, p99.9 and max latency, mean nodes traversed and callback time per operation.
+
+int mylisttrace_dump_chrome( list_trace_collector_pt collector, FILE *fp )
+{
+	trace_record_t *record;
+	long first, i;
+	int written = 0;
+	if(collector == NULL || fp == NULL)
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return -1;
+	}
+	pthread_mutex_lock(&collector->lock);
+	first = (collector->num_of_event > collector->max_events) ? collector->num_of_event - collector->max_events : 0;
+	fprintf(fp, "{\"traceEvents\":[\n");
+	for(i = first; i < collector->num_of_event; i++)
+	{
+		record = &collector->events[i % collector->max_events];
+		fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"mylist\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,"
+				"\"args\":{\"list\":\"%p\",\"index\":%d,\"nodes\":%ld,\"callbacks\":%ld,\"callback_us\":%.3f}}\n",
+				(written > 0) ? "," : "", mylist_trace_op_name(record->event.op), record->event.start/1000.0,
+				record->event.elapsed/1000.0, record->thread, (void *)record->event.list, record->event.index,
+				record->event.num_of_node, record->event.num_of_callback, record->event.callback_time/1000.0);
+		written++;
+	}
+	fprintf(fp, "],\"displayTimeUnit\":\"ns\"}\n");
+	pthread_mutex_unlock(&collector->lock);
+	if(ferror(fp))
+	{
+		list_errno = LIST_INVALID_ERROR;
+		return -1;
+	}
+	list_errno = LIST_NO_ERROR;
+	return written;
+}
+// Writes the kept events to 'fp' as Chrome trace-event JSON ("X" events, timestamps in microseconds,
+// or in 1000 TSC ticks with LIST_TRACE_TSC). Returns the number of written events,
+// or -1 and list_errno is set to LIST_INVALID_ERROR if 'collector' or 'fp' is NULL or writing failed.
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MYLISTTRACE_H_
+#define MYLISTTRACE_H_
+
+#include <stdio.h>
+#include "mylist.h"
+
+/*
+ * Trace collector for the LIST_TRACE hooks of mylist (build mylist.cpp and this file with -DLIST_TRACE, link with -pthread).
+ * Every event goes into a latency histogram per operation with log-linear buckets (like an HDR histogram with
+ * 32 sub-buckets per power of 2: a percentile is exact to within 1/32) and into a ring of the last events,
+ * which can be written as Chrome trace-event JSON (load it in chrome://tracing or Perfetto).
+ * Events from several threads may be recorded concurrently. Errors are reported through list_errno.
+ */
+
+#ifdef LIST_TRACE
+
+typedef struct list_trace_collector list_trace_collector_t;
+typedef list_trace_collector_t *list_trace_collector_pt;
+
+list_trace_collector_pt mylisttrace_create( int max_events );
+// Returns a pointer to a newly-allocated, empty collector that keeps the last 'max_events' events for
+// mylisttrace_dump_chrome (0 to keep histograms only).
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mylisttrace_free( list_trace_collector_pt *collector );
+// The collector is deleted (free memory) and set to NULL. Detach it first if it is attached.
+
+void mylisttrace_attach( list_trace_collector_pt collector );
+// Installs 'collector' as the 'after' trace hook of mylist (see mylist_set_trace_hooks).
+
+void mylisttrace_detach( void );
+// Removes the trace hooks of mylist.
+
+void mylisttrace_record( list_trace_collector_pt collector, const list_trace_event_t *event );
+// Adds 'event' to 'collector'. For use in an own hook that also does something else.
+
+void mylisttrace_reset( list_trace_collector_pt collector );
+// Forgets all recorded events.
+
+long mylisttrace_count( list_trace_collector_pt collector, int op );
+// Returns the number of recorded events of LIST_OP_* 'op', or of all operations if 'op' is -1.
+
+unsigned long long mylisttrace_percentile( list_trace_collector_pt collector, int op, double percentile );
+// Returns the elapsed time below which 'percentile' % (0 to 100) of the events of 'op' (-1 for all) fall.
+// Returns 0 if there are no such events.
+
+void mylisttrace_print( list_trace_collector_pt collector );
+// Prints a table with count, p50, p90, p99, p99.9 and max latency, mean nodes traversed and callback time per operation.
+// The table is made from one copy of the histograms taken under the lock, so it can be printed while other threads record.
+// list_errno is set to LIST_MEMORY_ERROR if the copy could not be allocated.
+
+int mylisttrace_dump_chrome( list_trace_collector_pt collector, FILE *fp );
+// Writes the kept events to 'fp' as Chrome trace-event JSON ("X" events, timestamps in microseconds,
+// or in 1000 TSC ticks with LIST_TRACE_TSC). Returns the number of written events,
+// or -1 and list_errno is set to LIST_INVALID_ERROR if 'collector' or 'fp' is NULL or writing failed.
+
+#endif
+
+#endif  //MYLISTTRACE_H_
@@ -0,0 +1,652 @@
+/*
+ ============================================================================
+ Name        : myrope.cpp
+ Author      : cph
+ Version     : 1.0
+ Copyright   : Copyright from Chi Pham Hoang
+ Description : Implementation of a rope: chunks of contiguous elements
+ 	 	 	   in a treap ordered by position
+ 	 	 	   Dynamic memory
+ Note 	     : 1) Every tree node holds one chunk and the number of
+ 	 	 	   elements in its subtree, so an index is found in O(log n).
+ 	 	 	   2) A full chunk is cut in two halves before an insert,
+ 	 	 	   an empty chunk is freed and a chunk below a quarter of its
+ 	 	 	   capacity is merged with a neighbour that has room, so
+ 	 	 	   removes can't leave a long run of nearly empty chunks.
+			   3) User must implement 2 functions to work with this API:
+			   - A compare function; to compare 2 elements in the rope
+			   - A print function: to print out an element to stdout
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "myrope.h"
+
+#ifdef DEBUG
+	#define DEBUG_PRINT(...) 															\
+	  do {					  															\
+		printf("In %s - function %s at line %d: ", __FILE__, __func__, __LINE__);		\
+		printf(__VA_ARGS__);															\
+	  } while(0)
+#else
+	#define DEBUG_PRINT(...) (void)0
+#endif
+
+#define ROPE_MIN_CHUNK 4
+
+/*
+ * The real definition of 'struct rope'
+ */
+typedef struct rope_node rope_node_t;
+struct rope_node {
+	rope_node_t *left;     // chunks before this one
+	rope_node_t *right;    // chunks after this one
+	uint32_t priority;     // heap order of the treap: a parent has a higher priority than its children
+	int num_of_element;    // elements in this chunk
+	int total;             // elements in this subtree
+	// followed by 'capacity' elements of 'element_size' bytes
+};
+
+struct rope {
+	rope_node_t *root;
+	rope_node_t *spare;    // one chunk kept for the next split, so a split can't fail half-way
+	int element_size;
+	int capacity;          // elements per chunk
+	uint32_t seed;         // xorshift state for the priorities
+	element_compare_func *element_compare; //callback function
+	element_print_func *element_print;
+};
+
+#define ROPE_ELEMENT(rope, node, i) ((char *)(node) + sizeof(rope_node_t) + (size_t)(i)*(rope)->element_size)
+#define ROPE_TOTAL(node) (((node) == NULL) ? 0 : (node)->total)
+
+/*
+ * Private functions
+ */
+static rope_node_t *rope_node_alloc( rope_pt rope )
+{
+	rope_node_t *node = rope->spare;
+	if(node != NULL) rope->spare = NULL;
+	else node = (rope_node_t *)malloc(sizeof(rope_node_t) + (size_t)rope->capacity*rope->element_size);
+	if(node == NULL) return NULL;
+	rope->seed ^= rope->seed << 13;
+	rope->seed ^= rope->seed >> 17;
+	rope->seed ^= rope->seed << 5;
+	node->priority = rope->seed;
+	node->left = NULL;
+	node->right = NULL;
+	node->num_of_element = 0;
+	node->total = 0;
+	return node;
+}
+// Returns an empty chunk with a random priority (the spare one if there is one), or NULL if memory allocation failed.
+
+static int rope_reserve( rope_pt rope )
+{
+	if(rope->spare == NULL) rope->spare = (rope_node_t *)malloc(sizeof(rope_node_t) + (size_t)rope->capacity*rope->element_size);
+	return (rope->spare == NULL) ? LIST_MEMORY_ERROR : LIST_NO_ERROR;
+}
+// Makes sure a spare chunk is available for rope_split. Returns LIST_MEMORY_ERROR if memory allocation failed.
+
+static void rope_node_release( rope_pt rope, rope_node_t *node )
+{
+	if(rope->spare == NULL) rope->spare = node; // keep one empty chunk for the next split
+	else free(node);
+}
+// Gives back a chunk that is no longer in the tree.
+
+static void rope_update( rope_node_t *node )
+{
+	node->total = ROPE_TOTAL(node->left) + node->num_of_element + ROPE_TOTAL(node->right);
+}
+
+static rope_node_t *rope_merge( rope_node_t *a, rope_node_t *b )
+{
+	if(a == NULL) return b;
+	if(b == NULL) return a;
+	if(a->priority >= b->priority)
+	{
+		a->right = rope_merge(a->right, b);
+		rope_update(a);
+		return a;
+	}
+	b->left = rope_merge(a, b->left);
+	rope_update(b);
+	return b;
+}
+// Returns the tree holding all elements of 'a' followed by all elements of 'b'.
+
+static void rope_split( rope_pt rope, rope_node_t *node, int index, rope_node_t **first, rope_node_t **rest )
+{
+	rope_node_t *cut;
+	int left, offset;
+
+	if(node == NULL)
+	{
+		*first = NULL;
+		*rest = NULL;
+		return;
+	}
+	left = ROPE_TOTAL(node->left);
+	if(index <= left)
+	{
+		rope_split(rope, node->left, index, first, &(node->left));
+		rope_update(node);
+		*rest = node;
+		return;
+	}
+	offset = index - left;
+	if(offset >= node->num_of_element)
+	{
+		rope_split(rope, node->right, offset - node->num_of_element, &(node->right), rest);
+		rope_update(node);
+		*first = node;
+		return;
+	}
+	//'index' falls inside this chunk: its tail moves to a new chunk in front of the right subtree
+	cut = rope_node_alloc(rope); // the spare chunk, never NULL here
+	cut->num_of_element = node->num_of_element - offset;
+	memcpy(ROPE_ELEMENT(rope, cut, 0), ROPE_ELEMENT(rope, node, offset), (size_t)cut->num_of_element*rope->element_size);
+	rope_update(cut);
+	node->num_of_element = offset;
+	*rest = rope_merge(cut, node->right);
+	node->right = NULL;
+	rope_update(node);
+	*first = node;
+}
+// Splits the tree 'node' in the first 'index' elements ('*first') and the others ('*rest').
+// At most one chunk is cut; rope_reserve must have succeeded before.
+
+static rope_node_t *rope_find( rope_pt rope, int *index )
+{
+	rope_node_t *node = rope->root;
+	int left;
+	for(;;)
+	{
+		left = ROPE_TOTAL(node->left);
+		if(*index < left)
+		{
+			node = node->left;
+			continue;
+		}
+		*index -= left;
+		if(*index < node->num_of_element) return node;
+		*index -= node->num_of_element;
+		node = node->right;
+	}
+}
+// Returns the chunk of the element at position '*index' and stores its offset in the chunk in '*index'.
+// 'rope' must not be empty and '*index' must already be clamped.
+
+static rope_node_t *rope_pop_first( rope_pt rope, rope_node_t *node )
+{
+	rope_node_t *right;
+	if(node->left == NULL)
+	{
+		right = node->right;
+		rope_node_release(rope, node);
+		return right;
+	}
+	node->left = rope_pop_first(rope, node->left);
+	rope_update(node);
+	return node;
+}
+// Takes the first chunk out of the tree 'node' (its elements must have been moved) and returns the new tree.
+
+static rope_node_t *rope_join( rope_pt rope, rope_node_t *a, rope_node_t *b )
+{
+	rope_node_t *last, *first, *node;
+	int n;
+
+	if(a == NULL) return b;
+	if(b == NULL) return a;
+	for(last = a; last->right != NULL; last = last->right);
+	for(first = b; first->left != NULL; first = first->left);
+	n = first->num_of_element;
+	if(last->num_of_element + n <= rope->capacity &&
+	   (last->num_of_element < rope->capacity/4 || n < rope->capacity/4))
+	{
+		//the chunks meeting at the seam fit in one and one of them is underfull: move the first chunk of 'b' into the last of 'a'
+		memcpy(ROPE_ELEMENT(rope, last, last->num_of_element), ROPE_ELEMENT(rope, first, 0), (size_t)n*rope->element_size);
+		last->num_of_element += n;
+		for(node = a; node != NULL; node = node->right) node->total += n;
+		b = rope_pop_first(rope, b);
+	}
+	return rope_merge(a, b);
+}
+// Same as rope_merge, but an underfull chunk at the seam is merged with the chunk on the other side if they fit in one.
+
+static void rope_pack( rope_pt rope, int index )
+{
+	rope_node_t *first, *chunk, *rest;
+	int offset = index;
+
+	chunk = rope_find(rope, &offset);
+	if(chunk->num_of_element >= rope->capacity/4) return;
+	//take the chunk out at its boundaries (nothing is cut) and join it with both neighbours
+	rope_split(rope, rope->root, index - offset, &first, &rest);
+	rope_split(rope, rest, chunk->num_of_element, &chunk, &rest);
+	rope->root = rope_join(rope, rope_join(rope, first, chunk), rest);
+}
+// Merges the chunk of the element at position 'index' with a neighbour chunk if it is underfull (less than a quarter
+// of the capacity) and they fit in one chunk. 'rope' must not be empty and 'index' must already be clamped.
+
+static int rope_insert( rope_pt rope, rope_node_t *node, int index, list_elm_pt element, int *start )
+{
+	int left = ROPE_TOTAL(node->left), status;
+	char *p;
+
+	if(index < left) status = rope_insert(rope, node->left, index, element, start);
+	else if(index - left <= node->num_of_element)
+	{
+		//insert in this chunk, at its end if 'index' is just after it
+		if(node->num_of_element == rope->capacity)
+		{
+			*start = left;
+			return LIST_MEMORY_ERROR;
+		}
+		p = ROPE_ELEMENT(rope, node, index - left);
+		memmove(p + rope->element_size, p, (size_t)(node->num_of_element - (index - left))*rope->element_size);
+		memcpy(p, element, rope->element_size);
+		node->num_of_element++;
+		status = LIST_NO_ERROR;
+	}
+	else
+	{
+		status = rope_insert(rope, node->right, index - left - node->num_of_element, element, start);
+		*start += left + node->num_of_element;
+	}
+	if(status == LIST_NO_ERROR) node->total++;
+	return status;
+}
+// Inserts 'element' at position 'index' of the subtree 'node' (0 <= 'index' <= its size).
+// Returns LIST_MEMORY_ERROR, without changing anything, if the chunk at 'index' is full,
+// and stores the position of that chunk in the subtree in '*start'.
+
+static rope_node_t *rope_remove( rope_pt rope, rope_node_t *node, int index, int *start )
+{
+	rope_node_t *merged;
+	int left = ROPE_TOTAL(node->left);
+	char *p;
+
+	if(index < left) node->left = rope_remove(rope, node->left, index, start);
+	else if(index - left < node->num_of_element)
+	{
+		p = ROPE_ELEMENT(rope, node, index - left);
+		node->num_of_element--;
+		memmove(p, p + rope->element_size, (size_t)(node->num_of_element - (index - left))*rope->element_size);
+		if(node->num_of_element == 0)
+		{
+			merged = rope_merge(node->left, node->right);
+			rope_node_release(rope, node);
+			return merged;
+		}
+		if(node->num_of_element < rope->capacity/4) *start = left;
+	}
+	else
+	{
+		node->right = rope_remove(rope, node->right, index - left - node->num_of_element, start);
+		if(*start >= 0) *start += left + node->num_of_element;
+	}
+	rope_update(node);
+	return node;
+}
+// Removes the element at position 'index' of the subtree 'node' and returns the new subtree.
+// If its chunk becomes underfull, the position of that chunk in the subtree is stored in '*start' (which must be -1 before).
+
+static void rope_free_tree( rope_node_t *node )
+{
+	if(node == NULL) return;
+	rope_free_tree(node->left);
+	rope_free_tree(node->right);
+	free(node);
+}
+
+static int rope_index_of( rope_pt rope, rope_node_t *node, list_elm_pt element, int base )
+{
+	int i, found;
+	if(node == NULL) return -1;
+	found = rope_index_of(rope, node->left, element, base);
+	if(found != -1) return found;
+	base += ROPE_TOTAL(node->left);
+	for(i = 0; i < node->num_of_element; i++)
+	{
+		if(rope->element_compare(ROPE_ELEMENT(rope, node, i), element) == 0) return base + i;
+	}
+	return rope_index_of(rope, node->right, element, base + node->num_of_element);
+}
+// Returns the position of the first element equal to 'element' in the subtree 'node' (which starts at position 'base'), or -1.
+
+static int rope_copy( rope_pt rope, rope_node_t *node, char *dest, int size )
+{
+	int count = 0, n;
+	if(node == NULL || size <= 0) return 0;
+	count = rope_copy(rope, node->left, dest, size);
+	n = (node->num_of_element < size - count) ? node->num_of_element : size - count;
+	memcpy(dest + (size_t)count*rope->element_size, ROPE_ELEMENT(rope, node, 0), (size_t)n*rope->element_size);
+	count += n;
+	return count + rope_copy(rope, node->right, dest + (size_t)count*rope->element_size, size - count);
+}
+// Copies at most 'size' elements of the subtree 'node' in order to 'dest'. Returns the number of copied elements.
+
+static void rope_print_tree( rope_pt rope, rope_node_t *node )
+{
+	int i;
+	if(node == NULL) return;
+	rope_print_tree(rope, node->left);
+	for(i = 0; i < node->num_of_element; i++) rope->element_print(ROPE_ELEMENT(rope, node, i));
+	rope_print_tree(rope, node->right);
+}
+
+/*
+ * Public functions
+ */
+rope_pt myrope_create( int element_size, element_compare_func *element_compare, element_print_func *element_print )
+{
+	rope_pt rope;
+
+	list_errno = LIST_NO_ERROR;
+	//Check the element size
+	if(element_size <= 0)
+	{
+		DEBUG_PRINT( "DEBUG:: Invalid element size\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	rope = (rope_pt) malloc(sizeof(rope_t));
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in rope allocating\n" );
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	rope->root = NULL;
+	rope->spare = NULL;
+	rope->element_size = element_size;
+	rope->capacity = (ROPE_CHUNK_BYTES/element_size > ROPE_MIN_CHUNK) ? ROPE_CHUNK_BYTES/element_size : ROPE_MIN_CHUNK;
+	rope->seed = 2463534242u;
+	rope->element_compare = element_compare;
+	rope->element_print = element_print;
+	return rope;
+}
+// Returns a pointer to a newly-allocated, empty rope for elements of 'element_size' bytes.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR,
+// or if 'element_size' is 0 or negative and list_errno is set to LIST_INVALID_ERROR
+
+void myrope_free( rope_pt *rope )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL || *rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	rope_free_tree((*rope)->root);
+	free((*rope)->spare);
+	free(*rope);
+	*rope = NULL;
+}
+// All chunks and the rope itself are deleted (free memory) and the rope is set to NULL
+
+int myrope_size( rope_pt rope )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG::List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return -1;
+	}
+	return ROPE_TOTAL(rope->root);
+}
+// Returns the number of elements in 'rope'.
+
+rope_pt myrope_insert_at_index( rope_pt rope, list_elm_pt element, int index )
+{
+	rope_node_t *first, *rest, *node;
+	int start;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	if(index < 0) index = 0;
+	if(index > ROPE_TOTAL(rope->root)) index = ROPE_TOTAL(rope->root);
+	if(rope->root == NULL)
+	{
+		rope->root = rope_node_alloc(rope);
+		if(rope->root == NULL)
+		{
+			DEBUG_PRINT( "DEBUG:: Error in allocating a chunk\n" );
+			list_errno = LIST_MEMORY_ERROR;
+			return NULL;
+		}
+	}
+	//while the chunk at 'index' is full, cut it in two halves
+	while(rope_insert(rope, rope->root, index, element, &start) != LIST_NO_ERROR)
+	{
+		if(rope_reserve(rope) != LIST_NO_ERROR)
+		{
+			DEBUG_PRINT( "DEBUG:: Error in allocating a chunk\n" );
+			list_errno = LIST_MEMORY_ERROR;
+			return NULL;
+		}
+		if(index == start || index == start + rope->capacity)
+		{
+			//at the front or back of the full chunk: start a new chunk there, so appends keep the chunks full,
+			//unless the chunk on the other side of the boundary has room for it
+			node = rope_node_alloc(rope);
+			memcpy(ROPE_ELEMENT(rope, node, 0), element, rope->element_size);
+			node->num_of_element = 1;
+			rope_update(node);
+			rope_split(rope, rope->root, index, &first, &rest); // 'index' is a chunk boundary: nothing is cut
+			rope->root = rope_join(rope, rope_join(rope, first, node), rest);
+			return rope;
+		}
+		rope_split(rope, rope->root, start + rope->capacity/2, &first, &rest);
+		rope->root = rope_merge(first, rest);
+	}
+	return rope;
+}
+// Inserts a copy of the 'element_size' bytes at 'element' in 'rope' at position 'index' and returns 'rope'.
+// If 'index' is 0 or negative, the element is inserted at the start of 'rope'.
+// If 'index' is bigger than the number of elements in 'rope', the element is inserted at the end of 'rope'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+rope_pt myrope_remove_at_index( rope_pt rope, int index )
+{
+	int start;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	//Check the rope is empty
+	if(rope->root == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return rope;
+	}
+	//Check if index is negative or out of rope range
+	if(index < 0) index = 0;
+	if(index >= rope->root->total) index = rope->root->total-1;
+	start = -1;
+	rope->root = rope_remove(rope, rope->root, index, &start);
+	if(start >= 0) rope_pack(rope, start);
+	return rope;
+}
+// Removes the element at index 'index' from 'rope'. A chunk that becomes empty is freed,
+// a chunk that falls below a quarter of its capacity is merged with a neighbour chunk if they fit in one.
+// If 'index' is 0 or negative, the first element is removed.
+// If 'index' is bigger than the number of elements in 'rope', the last element is removed.
+// If the rope is empty, return rope and list_errno is set to LIST_EMPTY_ERROR
+
+list_elm_pt myrope_get_element_at_index( rope_pt rope, int index )
+{
+	int num_of_element;
+	return myrope_get_run(rope, index, &num_of_element);
+}
+// Returns a pointer to the element with index 'index' inside its chunk. It is valid until the next change of 'rope'.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'rope', the last element is returned.
+// If the rope is empty, NULL is returned.
+
+list_elm_pt myrope_get_run( rope_pt rope, int index, int *num_of_element )
+{
+	rope_node_t *node;
+
+	list_errno = LIST_NO_ERROR;
+	*num_of_element = 0;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	//Check the rope is empty
+	if(rope->root == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return NULL;
+	}
+	//Check if index is negative or out of rope range
+	if(index < 0) index = 0;
+	if(index >= rope->root->total) index = rope->root->total-1;
+	node = rope_find(rope, &index);
+	*num_of_element = node->num_of_element - index;
+	return ROPE_ELEMENT(rope, node, index);
+}
+// Same as myrope_get_element_at_index, and stores in '*num_of_element' how many elements (from 'index' on)
+// follow contiguously in the same chunk. Stores 0 if the rope is empty.
+
+int myrope_get_index_of_element( rope_pt rope, list_elm_pt element )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return -1;
+	}
+	//Check the rope is empty
+	if(rope->root == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return -1;
+	}
+	//Check the element is NULL
+	if(element == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Input element is NULL\n" );
+		list_errno = ELEMENT_INVALID_ERROR;
+		return -1;
+	}
+	return rope_index_of(rope, rope->root, element, 0);
+}
+// Returns an index to the first element in 'rope' that compares equal to 'element'.
+// If 'element' is not found in 'rope', -1 is returned.
+
+int myrope_to_array( rope_pt rope, list_elm_pt array, int size )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL || (size > 0 && array == NULL))
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = (rope == NULL) ? LIST_INVALID_ERROR : ELEMENT_INVALID_ERROR;
+		return -1;
+	}
+	return rope_copy(rope, rope->root, (char *)array, size);
+}
+// Copies the elements of 'rope' in order into 'array' (at most 'size' elements), one memcpy per chunk.
+// Returns the number of copied elements, or -1 if 'rope' or 'array' is NULL.
+
+rope_pt myrope_split( rope_pt rope, int index )
+{
+	rope_pt rest;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	rest = myrope_create(rope->element_size, rope->element_compare, rope->element_print);
+	if(rest == NULL) return NULL;
+	if(rope_reserve(rope) != LIST_NO_ERROR)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in allocating a chunk\n" );
+		free(rest);
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	if(index < 0) index = 0;
+	rope_split(rope, rope->root, index, &(rope->root), &(rest->root));
+	//the chunk cut at 'index' may leave an underfull chunk on either side
+	if(rope->root != NULL) rope_pack(rope, rope->root->total - 1);
+	if(rest->root != NULL) rope_pack(rest, 0);
+	return rest;
+}
+// Moves the elements from index 'index' on to a newly-allocated rope and returns it; 'rope' keeps the first 'index' elements.
+// If 'index' is 0 or negative, all elements are moved; if it is not smaller than the size of 'rope', none.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR ('rope' is unchanged then).
+
+rope_pt myrope_concat( rope_pt rope, rope_pt other )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the ropes are NULL
+	if(rope == NULL || other == NULL || rope == other || rope->element_size != other->element_size)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	rope->root = rope_join(rope, rope->root, other->root);
+	other->root = NULL;
+	return rope;
+}
+// Moves all elements of 'other' to the end of 'rope' ('other' becomes empty) and returns 'rope'.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if a rope is NULL, both are the same rope
+// or their element sizes differ.
+
+void myrope_print( rope_pt rope )
+{
+	list_errno = LIST_NO_ERROR;
+	//check if the rope is NULL
+	if(rope == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	//Check the rope is empty
+	if(rope->root == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return;
+	}
+	rope_print_tree(rope, rope->root);
+}
+// for testing purposes: print the entire rope on screen
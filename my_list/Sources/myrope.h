@@ -0,0 +1,81 @@
+#ifndef MYROPE_H_
+#define MYROPE_H_
+
+#include "mylist.h"
+
+/*
+ * Rope: a sequence of elements of 'element_size' bytes stored in chunks of contiguous elements
+ * (ROPE_CHUNK_BYTES bytes each), which are the nodes of a balanced tree (treap) that keeps the number
+ * of elements of every subtree. Insert, remove and lookup at an index are O(log n), a scan copies whole chunks.
+ * Chunks below a quarter of their capacity are merged with a neighbour chunk that has room.
+ * Splitting a rope at an index and concatenating two ropes are O(log n) as well and copy at most one chunk of elements.
+ * Elements are copied in and out with memcpy (no element_copy/element_free callbacks).
+ * Index semantics (clamping of 'index') are the same as for mylist; errors are reported through list_errno.
+ */
+
+#ifndef ROPE_CHUNK_BYTES
+	#define ROPE_CHUNK_BYTES 1024 // bytes of elements per chunk (at least 4 elements per chunk)
+#endif
+
+typedef struct rope rope_t;
+typedef rope_t *rope_pt;
+
+rope_pt myrope_create( int element_size, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a pointer to a newly-allocated, empty rope for elements of 'element_size' bytes.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR,
+// or if 'element_size' is 0 or negative and list_errno is set to LIST_INVALID_ERROR
+
+void myrope_free( rope_pt *rope );
+// All chunks and the rope itself are deleted (free memory) and the rope is set to NULL
+
+int myrope_size( rope_pt rope );
+// Returns the number of elements in 'rope'.
+
+rope_pt myrope_insert_at_index( rope_pt rope, list_elm_pt element, int index );
+// Inserts a copy of the 'element_size' bytes at 'element' in 'rope' at position 'index' and returns 'rope'.
+// If 'index' is 0 or negative, the element is inserted at the start of 'rope'.
+// If 'index' is bigger than the number of elements in 'rope', the element is inserted at the end of 'rope'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+rope_pt myrope_remove_at_index( rope_pt rope, int index );
+// Removes the element at index 'index' from 'rope'. A chunk that becomes empty is freed,
+// a chunk that falls below a quarter of its capacity is merged with a neighbour chunk if they fit in one.
+// If 'index' is 0 or negative, the first element is removed.
+// If 'index' is bigger than the number of elements in 'rope', the last element is removed.
+// If the rope is empty, return rope and list_errno is set to LIST_EMPTY_ERROR
+
+list_elm_pt myrope_get_element_at_index( rope_pt rope, int index );
+// Returns a pointer to the element with index 'index' inside its chunk. It is valid until the next change of 'rope'.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'rope', the last element is returned.
+// If the rope is empty, NULL is returned.
+
+list_elm_pt myrope_get_run( rope_pt rope, int index, int *num_of_element );
+// Same as myrope_get_element_at_index, and stores in '*num_of_element' how many elements (from 'index' on)
+// follow contiguously in the same chunk, so a scan can work chunk by chunk:
+//   for(i = 0; i < size; i += n) { p = myrope_get_run(rope, i, &n); ... p[0..n-1] ... }
+// Stores 0 if the rope is empty.
+
+int myrope_get_index_of_element( rope_pt rope, list_elm_pt element );
+// Returns an index to the first element in 'rope' that compares equal to 'element'.
+// If 'element' is not found in 'rope', -1 is returned.
+
+int myrope_to_array( rope_pt rope, list_elm_pt array, int size );
+// Copies the elements of 'rope' in order into 'array' (at most 'size' elements), one memcpy per chunk.
+// Returns the number of copied elements, or -1 if 'rope' or 'array' is NULL.
+
+rope_pt myrope_split( rope_pt rope, int index );
+// Moves the elements from index 'index' on to a newly-allocated rope and returns it; 'rope' keeps the first 'index' elements.
+// If 'index' is 0 or negative, all elements are moved; if it is not smaller than the size of 'rope', none.
+// A slice [first, first+count[ is myrope_split(rope, first) followed by myrope_split(slice, count) on the result.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR ('rope' is unchanged then).
+
+rope_pt myrope_concat( rope_pt rope, rope_pt other );
+// Moves all elements of 'other' to the end of 'rope' ('other' becomes empty) and returns 'rope'.
+// Returns NULL and list_errno is set to LIST_INVALID_ERROR if a rope is NULL, both are the same rope
+// or their element sizes differ.
+
+void myrope_print( rope_pt rope );
+// for testing purposes: print the entire rope on screen
+
+#endif  //MYROPE_H_
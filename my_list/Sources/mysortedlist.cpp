@@ -0,0 +1,522 @@
+/*
+ ============================================================================
+ Name        : mysortedlist.cpp
+ Author      : cph
+ Version     : 1.0
+ Copyright   : Copyright from Chi Pham Hoang
+ Description : Implementation of a sorted list as an indexable skip list
+ 	 	 	   Dynamic memory
+ Note 	     : 1) Level 0 is a double-linked list, so walking the list in
+ 	 	 	   order works like mylist.
+ 	 	 	   2) Every express lane stores its span (number of level 0
+ 	 	 	   steps it skips) to answer rank and index queries in O(log n).
+			   3) User must implement the same 4 callback functions as for
+			   mylist, element_compare must be a three-way compare.
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mysortedlist.h"
+
+#ifdef DEBUG
+	#define DEBUG_PRINT(...) 															\
+	  do {					  															\
+		printf("In %s - function %s at line %d: ", __FILE__, __func__, __LINE__);		\
+		printf(__VA_ARGS__);															\
+	  } while(0)
+#else
+	#define DEBUG_PRINT(...) (void)0
+#endif
+
+#define SORTED_MAX_LEVEL 32
+
+/*
+ * The real definition of 'struct sorted_list'
+ */
+typedef struct sorted_lane {
+	sorted_node_pt next;
+	int span;
+} sorted_lane_t;
+
+struct sorted_node {
+	list_elm_pt element;
+	sorted_node_pt prev;
+	sorted_lane_t lane[1]; // 'level' lanes are allocated
+};
+
+struct sorted_list {
+	sorted_node_pt head; // sentinel with SORTED_MAX_LEVEL lanes, holds no element
+	sorted_node_pt tail;
+	int level;
+	int num_of_element;
+	unsigned int seed;
+	element_copy_func *element_copy; //callback function
+	element_free_func *element_free;
+	element_compare_func *element_compare;
+	element_print_func *element_print;
+};
+
+/*
+ * Private functions
+ */
+static sorted_node_pt sorted_node_create( int level )
+{
+	return (sorted_node_pt) malloc(sizeof(sorted_node_t) + (level-1)*sizeof(sorted_lane_t));
+}
+
+static int sorted_random_level( sorted_list_pt list )
+{
+	int level = 1;
+	unsigned int x = list->seed; //xorshift, so no global rand() state is shared between lists
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	list->seed = x;
+	while((x & 3) == 0 && level < SORTED_MAX_LEVEL) // p = 1/4
+	{
+		level++;
+		x >>= 2;
+	}
+	return level;
+}
+
+static sorted_node_pt sorted_search( sorted_list_pt list, list_elm_pt element, int max_compare, sorted_node_pt *update, int *rank )
+{
+	int i;
+	sorted_node_pt x = list->head;
+	for(i = list->level-1; i >= 0; i--)
+	{
+		if(rank != NULL) rank[i] = (i == list->level-1) ? 0 : rank[i+1];
+		while(x->lane[i].next != NULL && list->element_compare(x->lane[i].next->element, element) <= max_compare)
+		{
+			if(rank != NULL) rank[i] += x->lane[i].span;
+			x = x->lane[i].next;
+		}
+		if(update != NULL) update[i] = x;
+	}
+	return x;
+}
+// Returns the last node whose element compares <= 'max_compare' against 'element' (the head if there is none).
+// max_compare -1 stops before equal elements, 0 stops after them.
+// 'update' and 'rank' receive the last node visited and its rank on every level.
+
+static void sorted_unlink( sorted_list_pt list, sorted_node_pt x, sorted_node_pt *update )
+{
+	int i;
+	for(i = 0; i < list->level; i++)
+	{
+		if(update[i]->lane[i].next == x)
+		{
+			update[i]->lane[i].span += x->lane[i].span - 1;
+			update[i]->lane[i].next = x->lane[i].next;
+		}
+		else
+		{
+			update[i]->lane[i].span--;
+		}
+	}
+	if(x->lane[0].next != NULL) x->lane[0].next->prev = x->prev;
+	else list->tail = x->prev;
+	while(list->level > 1 && list->head->lane[list->level-1].next == NULL) list->level--;
+	list->num_of_element--;
+}
+
+static sorted_list_pt sorted_insert( sorted_list_pt list, list_elm_pt element, int unique )
+{
+	sorted_node_pt update[SORTED_MAX_LEVEL];
+	int rank[SORTED_MAX_LEVEL];
+	sorted_node_pt x;
+	int i, level;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	x = sorted_search(list, element, 0, update, rank);
+	if(unique && x != list->head && list->element_compare(x->element, element) == 0) return list;
+
+	level = sorted_random_level(list);
+	x = sorted_node_create(level);
+	if(x == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in allocating a new sorted_node\n" );
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	list->element_copy(&(x->element), element); //make a deep copy
+	if(level > list->level)
+	{
+		for(i = list->level; i < level; i++)
+		{
+			rank[i] = 0;
+			update[i] = list->head;
+			update[i]->lane[i].span = list->num_of_element;
+		}
+		list->level = level;
+	}
+	for(i = 0; i < level; i++)
+	{
+		x->lane[i].next = update[i]->lane[i].next;
+		update[i]->lane[i].next = x;
+		x->lane[i].span = update[i]->lane[i].span - (rank[0] - rank[i]);
+		update[i]->lane[i].span = (rank[0] - rank[i]) + 1;
+	}
+	for(i = level; i < list->level; i++)
+	{
+		update[i]->lane[i].span++;
+	}
+	x->prev = (update[0] == list->head) ? NULL : update[0];
+	if(x->lane[0].next != NULL) x->lane[0].next->prev = x;
+	else list->tail = x;
+	list->num_of_element++;
+	return list;
+}
+
+static sorted_list_pt sorted_remove( sorted_list_pt list, list_elm_pt element, int free_element )
+{
+	sorted_node_pt update[SORTED_MAX_LEVEL];
+	sorted_node_pt x;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return NULL;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return list;
+	}
+	x = sorted_search(list, element, -1, update, NULL)->lane[0].next;
+	if(x == NULL || list->element_compare(x->element, element) != 0) return list;
+	sorted_unlink(list, x, update);
+	if(free_element) list->element_free(&(x->element));
+	free(x);
+	return list;
+}
+
+/*
+ * Public functions
+ */
+sorted_list_pt mysortedlist_create( element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print )
+{
+	int i;
+	sorted_list_pt list;
+
+	list_errno = LIST_NO_ERROR;
+	list = (sorted_list_pt) malloc(sizeof(sorted_list_t));
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in list allocating\n" );
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	list->head = sorted_node_create(SORTED_MAX_LEVEL);
+	if(list->head == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: Error in list allocating\n" );
+		free(list);
+		list_errno = LIST_MEMORY_ERROR;
+		return NULL;
+	}
+	list->head->element = NULL;
+	list->head->prev = NULL;
+	for(i = 0; i < SORTED_MAX_LEVEL; i++)
+	{
+		list->head->lane[i].next = NULL;
+		list->head->lane[i].span = 0;
+	}
+	list->tail = NULL;
+	list->level = 1;
+	list->num_of_element = 0;
+	list->seed = 0x9E3779B9u;
+	list->element_copy = element_copy;
+	list->element_free = element_free;
+	list->element_compare = element_compare;
+	list->element_print = element_print;
+	return list;
+}
+// Returns a pointer to a newly-allocated, empty sorted list.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mysortedlist_free( sorted_list_pt *list )
+{
+	sorted_node_pt temp, next;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL || *list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	temp = (*list)->head->lane[0].next;
+	while(temp != NULL)
+	{
+		next = temp->lane[0].next;
+		(*list)->element_free(&(temp->element));
+		free(temp);
+		temp = next;
+	}
+	free((*list)->head);
+	free(*list);
+	*list = NULL;
+}
+// Every node and element of the list is deleted (free memory) and the list itself is deleted and set to NULL
+
+int mysortedlist_size_r( sorted_list_pt list, int *size )
+{
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG::List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	*size = list->num_of_element;
+	return LIST_NO_ERROR;
+}
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mysortedlist_size( sorted_list_pt list )
+{
+	int size = -1;
+	list_errno = mysortedlist_size_r(list, &size);
+	return size;
+}
+// Returns the number of elements in 'list'.
+
+sorted_list_pt mysortedlist_insert( sorted_list_pt list, list_elm_pt element )
+{
+	return sorted_insert(list, element, 0);
+}
+// Inserts a copy of 'element' at its sorted position, after any elements that compare equal, and returns 'list'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+sorted_list_pt mysortedlist_insert_unique( sorted_list_pt list, list_elm_pt element )
+{
+	return sorted_insert(list, element, 1);
+}
+// Same as mysortedlist_insert, but nothing is inserted if an equal element is already in 'list'.
+
+sorted_list_pt mysortedlist_remove_element( sorted_list_pt list, list_elm_pt element )
+{
+	return sorted_remove(list, element, 0);
+}
+// Removes the first node of 'list' whose element compares equal to 'element'. NO free() is called on the element.
+// If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
+
+sorted_list_pt mysortedlist_free_element( sorted_list_pt list, list_elm_pt element )
+{
+	return sorted_remove(list, element, 1);
+}
+// Same as mysortedlist_remove_element, but the element of the removed node is freed with 'element_free'.
+
+int mysortedlist_find_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference )
+{
+	int status = mysortedlist_lower_bound_r(list, element, reference);
+	if(*reference != NULL && list->element_compare((*reference)->element, element) != 0) *reference = NULL;
+	return status;
+}
+// Stores a reference to the first node whose element compares equal to 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+sorted_node_pt mysortedlist_find( sorted_list_pt list, list_elm_pt element )
+{
+	sorted_node_pt reference;
+	list_errno = mysortedlist_find_r(list, element, &reference);
+	return reference;
+}
+// Returns a reference to the first node whose element compares equal to 'element', or NULL if there is none.
+
+int mysortedlist_lower_bound_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference )
+{
+	*reference = NULL;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	*reference = sorted_search(list, element, -1, NULL, NULL)->lane[0].next;
+	return LIST_NO_ERROR;
+}
+// Stores a reference to the first node whose element is not smaller than 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+sorted_node_pt mysortedlist_lower_bound( sorted_list_pt list, list_elm_pt element )
+{
+	sorted_node_pt reference;
+	list_errno = mysortedlist_lower_bound_r(list, element, &reference);
+	return reference;
+}
+// Returns a reference to the first node whose element is not smaller than 'element', or NULL if there is none.
+
+int mysortedlist_upper_bound_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference )
+{
+	*reference = NULL;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	*reference = sorted_search(list, element, 0, NULL, NULL)->lane[0].next;
+	return LIST_NO_ERROR;
+}
+// Stores a reference to the first node whose element is bigger than 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+sorted_node_pt mysortedlist_upper_bound( sorted_list_pt list, list_elm_pt element )
+{
+	sorted_node_pt reference;
+	list_errno = mysortedlist_upper_bound_r(list, element, &reference);
+	return reference;
+}
+// Returns a reference to the first node whose element is bigger than 'element', or NULL if there is none.
+
+int mysortedlist_rank_r( sorted_list_pt list, list_elm_pt element, int *rank )
+{
+	int ranks[SORTED_MAX_LEVEL];
+
+	*rank = -1;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	sorted_search(list, element, -1, NULL, ranks);
+	*rank = ranks[0];
+	return LIST_NO_ERROR;
+}
+// Stores the number of elements in 'list' that are smaller than 'element' in '*rank'.
+// Returns LIST_INVALID_ERROR and stores -1 if 'list' is NULL.
+
+int mysortedlist_rank( sorted_list_pt list, list_elm_pt element )
+{
+	int rank;
+	list_errno = mysortedlist_rank_r(list, element, &rank);
+	return rank;
+}
+// Returns the number of elements in 'list' that are smaller than 'element' (the index of its lower bound).
+// Returns -1 if 'list' is NULL.
+
+int mysortedlist_get_element_at_index_r( sorted_list_pt list, int index, list_elm_pt *element )
+{
+	int i, traversed = 0;
+	sorted_node_pt x;
+
+	*element = NULL;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		return LIST_INVALID_ERROR;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		return LIST_EMPTY_ERROR;
+	}
+	//Check if index is negative or out of list range
+	if(index < 0) index = 0;
+	if(index >= (list->num_of_element)) index = list->num_of_element-1;
+	x = list->head;
+	for(i = list->level-1; i >= 0; i--)
+	{
+		while(x->lane[i].next != NULL && traversed + x->lane[i].span <= index+1)
+		{
+			traversed += x->lane[i].span;
+			x = x->lane[i].next;
+		}
+	}
+	*element = x->element; //an element pointer of the list (not a copy)-> be careful!!!
+	return LIST_NO_ERROR;
+}
+// Stores the element with index 'index' in sorted order in '*element' (same clamping as mysortedlist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+list_elm_pt mysortedlist_get_element_at_index( sorted_list_pt list, int index )
+{
+	list_elm_pt element;
+	list_errno = mysortedlist_get_element_at_index_r(list, index, &element);
+	return element;
+}
+// Returns the element with index 'index' in sorted order.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'list', the last element is returned.
+// If the list is empty, NULL is returned.
+
+sorted_node_pt mysortedlist_get_first_reference( sorted_list_pt list )
+{
+	if(list == NULL) return NULL;
+	return list->head->lane[0].next;
+}
+// Returns a reference to the smallest node of 'list', or NULL if the list is empty.
+
+sorted_node_pt mysortedlist_get_last_reference( sorted_list_pt list )
+{
+	if(list == NULL) return NULL;
+	return list->tail;
+}
+// Returns a reference to the biggest node of 'list', or NULL if the list is empty.
+
+sorted_node_pt mysortedlist_get_next_reference( sorted_node_pt reference )
+{
+	if(reference == NULL) return NULL;
+	return reference->lane[0].next;
+}
+// Returns a reference to the next node in sorted order, or NULL at the end.
+
+sorted_node_pt mysortedlist_get_previous_reference( sorted_node_pt reference )
+{
+	if(reference == NULL) return NULL;
+	return reference->prev;
+}
+// Returns a reference to the previous node in sorted order, or NULL at the start.
+
+list_elm_pt mysortedlist_get_element_at_reference( sorted_node_pt reference )
+{
+	if(reference == NULL) return NULL;
+	return reference->element;
+}
+// Returns the element pointer contained in the node 'reference' (not a copy), or NULL if 'reference' is NULL.
+
+void mysortedlist_print( sorted_list_pt list )
+{
+	sorted_node_pt temp;
+
+	list_errno = LIST_NO_ERROR;
+	//check if the list is NULL
+	if(list == NULL)
+	{
+		DEBUG_PRINT( "DEBUG:: List invalid error\n" );
+		list_errno = LIST_INVALID_ERROR;
+		return;
+	}
+	//Check the list is empty
+	if(list->num_of_element == 0)
+	{
+		DEBUG_PRINT( "DEBUG:: List is empty\n" );
+		list_errno = LIST_EMPTY_ERROR;
+		return;
+	}
+	for(temp = list->head->lane[0].next; temp != NULL; temp = temp->lane[0].next)
+	{
+		list->element_print(temp->element);
+	}
+}
+// for testing purposes: print the entire list on screen in sorted order
@@ -0,0 +1,114 @@
+#ifndef MYSORTEDLIST_H_
+#define MYSORTEDLIST_H_
+
+#include "mylist.h"
+
+/*
+ * Sorted list: keeps its elements in ascending order according to the three-way 'element_compare'
+ * callback (<0, 0 or >0). It is an indexable skip list: the bottom level is a double-linked list like
+ * mylist, the upper levels are express lanes that store how many nodes they skip.
+ * Insert, find, lower/upper bound, rank and index lookup are O(log n); walking the references is O(1) per step.
+ * Equal elements are allowed and kept in insertion order (multiset/multimap); use mysortedlist_insert_unique for set/map behaviour.
+ * Errors are reported through list_errno with the same codes as mylist; the read-only queries also have
+ * status returning _r forms that leave list_errno alone (see below).
+ */
+
+typedef struct sorted_node sorted_node_t;
+typedef sorted_node_t *sorted_node_pt;
+
+typedef struct sorted_list sorted_list_t;
+typedef sorted_list_t *sorted_list_pt;
+
+sorted_list_pt mysortedlist_create( element_copy_func *element_copy, element_free_func *element_free, element_compare_func *element_compare, element_print_func *element_print );
+// Returns a pointer to a newly-allocated, empty sorted list.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+void mysortedlist_free( sorted_list_pt *list );
+// Every node and element of the list is deleted (free memory) and the list itself is deleted and set to NULL
+
+int mysortedlist_size( sorted_list_pt list );
+// Returns the number of elements in 'list'.
+
+sorted_list_pt mysortedlist_insert( sorted_list_pt list, list_elm_pt element );
+// Inserts a copy of 'element' at its sorted position, after any elements that compare equal, and returns 'list'.
+// Returns NULL if memory allocation failed and list_errno is set to LIST_MEMORY_ERROR
+
+sorted_list_pt mysortedlist_insert_unique( sorted_list_pt list, list_elm_pt element );
+// Same as mysortedlist_insert, but nothing is inserted if an equal element is already in 'list'.
+
+sorted_list_pt mysortedlist_remove_element( sorted_list_pt list, list_elm_pt element );
+// Removes the first node of 'list' whose element compares equal to 'element'. NO free() is called on the element.
+// If the list is empty, return list and list_errno is set to LIST_EMPTY_ERROR
+
+sorted_list_pt mysortedlist_free_element( sorted_list_pt list, list_elm_pt element );
+// Same as mysortedlist_remove_element, but the element of the removed node is freed with 'element_free'.
+
+sorted_node_pt mysortedlist_find( sorted_list_pt list, list_elm_pt element );
+// Returns a reference to the first node whose element compares equal to 'element', or NULL if there is none.
+
+sorted_node_pt mysortedlist_lower_bound( sorted_list_pt list, list_elm_pt element );
+// Returns a reference to the first node whose element is not smaller than 'element', or NULL if there is none.
+
+sorted_node_pt mysortedlist_upper_bound( sorted_list_pt list, list_elm_pt element );
+// Returns a reference to the first node whose element is bigger than 'element', or NULL if there is none.
+
+int mysortedlist_rank( sorted_list_pt list, list_elm_pt element );
+// Returns the number of elements in 'list' that are smaller than 'element' (the index of its lower bound).
+// Returns -1 if 'list' is NULL.
+
+list_elm_pt mysortedlist_get_element_at_index( sorted_list_pt list, int index );
+// Returns the element with index 'index' in sorted order.
+// If 'index' is 0 or negative, the first element is returned.
+// If 'index' is bigger than the number of elements in 'list', the last element is returned.
+// If the list is empty, NULL is returned.
+
+sorted_node_pt mysortedlist_get_first_reference( sorted_list_pt list );
+// Returns a reference to the smallest node of 'list', or NULL if the list is empty.
+
+sorted_node_pt mysortedlist_get_last_reference( sorted_list_pt list );
+// Returns a reference to the biggest node of 'list', or NULL if the list is empty.
+
+sorted_node_pt mysortedlist_get_next_reference( sorted_node_pt reference );
+// Returns a reference to the next node in sorted order, or NULL at the end.
+
+sorted_node_pt mysortedlist_get_previous_reference( sorted_node_pt reference );
+// Returns a reference to the previous node in sorted order, or NULL at the start.
+
+list_elm_pt mysortedlist_get_element_at_reference( sorted_node_pt reference );
+// Returns the element pointer contained in the node 'reference' (not a copy), or NULL if 'reference' is NULL.
+
+/*
+ * Status returning API
+ * Like the mylist_*_r functions, these return LIST_NO_ERROR or an error code, pass the result back through
+ * the last argument and never write list_errno, so several threads can query the same list concurrently.
+ * The queries above are wrappers around these that copy the returned code into list_errno.
+ */
+
+int mysortedlist_size_r( sorted_list_pt list, int *size );
+// Stores the number of elements in 'list' in '*size'.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mysortedlist_find_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference );
+// Stores a reference to the first node whose element compares equal to 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mysortedlist_lower_bound_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference );
+// Stores a reference to the first node whose element is not smaller than 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mysortedlist_upper_bound_r( sorted_list_pt list, list_elm_pt element, sorted_node_pt *reference );
+// Stores a reference to the first node whose element is bigger than 'element' in '*reference', or NULL if there is none.
+// Returns LIST_INVALID_ERROR if 'list' is NULL.
+
+int mysortedlist_rank_r( sorted_list_pt list, list_elm_pt element, int *rank );
+// Stores the number of elements in 'list' that are smaller than 'element' in '*rank'.
+// Returns LIST_INVALID_ERROR and stores -1 if 'list' is NULL.
+
+int mysortedlist_get_element_at_index_r( sorted_list_pt list, int index, list_elm_pt *element );
+// Stores the element with index 'index' in sorted order in '*element' (same clamping as mysortedlist_get_element_at_index).
+// On error NULL is stored and LIST_INVALID_ERROR or LIST_EMPTY_ERROR is returned.
+
+void mysortedlist_print( sorted_list_pt list );
+// for testing purposes: print the entire list on screen in sorted order
+
+#endif  //MYSORTEDLIST_H_
@@ -0,0 +1,317 @@
+//============================================================================
+// Name        : test_cache.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of mylistcache
+//               Random get/peek/put/erase/evict sequences on LRU and LFU
+//               caches, with entry and byte limits, are checked against a
+//               std::vector model of the eviction order, plus the case of
+//               new keys put into a full cache of used keys. Then a hit
+//               is timed against the plain list lookup it replaces
+//               (index_of, remove, insert at the front).
+//
+//               Build: g++ -O2 test_cache.cpp mylistcache.cpp mylist.cpp -o test_cache
+//               Usage: test_cache [seed] [number of rounds]
+//============================================================================
+
+#include <vector>
+#include "mylistcache.h"
+#define CHECK_COUNTER round
+#include "test_common.h"
+using namespace std;
+
+/*
+ * Key/value element, the cache callbacks only look at the key
+ */
+typedef struct entry {
+  int key;
+  int value;
+} entry_t;
+
+/*
+ * Model of one cached entry
+ */
+typedef struct model_entry {
+  int key;
+  int value;
+  long hit_count;
+  long last_use;
+} model_entry_t;
+
+static void entry_copy(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  entry_t *copy = (entry_t *)malloc(sizeof(entry_t));
+  if(copy != NULL) *copy = *(entry_t *)src_element;
+  *dest_element = copy;
+}
+
+static int entry_compare(list_elm_pt x, list_elm_pt y)
+{
+  if(((entry_t *)x)->key < ((entry_t *)y)->key) { return -1; }
+  if(((entry_t *)x)->key > ((entry_t *)y)->key) { return 1; }
+  return 0;
+}
+
+static unsigned long entry_hash(list_elm_pt x)
+{
+  return (unsigned long)((entry_t *)x)->key * 2654435761u;
+}
+
+static size_t element_size(list_elm_pt x)
+{
+  return ((entry_t *)x)->key % 7 + 1;
+}
+
+static void element_print(list_elm_pt x)
+{
+  printf("%d:%d\n", ((entry_t *)x)->key, ((entry_t *)x)->value);
+}
+
+static int model_find( const vector<model_entry_t> &model, int key )
+{
+  for(int i = 0; i < (int)model.size(); i++)
+  {
+    if(model[i].key == key) return i;
+  }
+  return -1;
+}
+
+/*
+ * Returns the entry the cache evicts next, never 'keep' (the entry just put) unless it is the only one.
+ * LRU: the least recently used. LFU: the lowest hit count, the least recently used of those.
+ */
+static int model_victim( const vector<model_entry_t> &model, int policy, int keep )
+{
+  int i, victim = -1;
+  for(i = 0; i < (int)model.size(); i++)
+  {
+    if(i == keep) continue;
+    if(victim < 0 ||
+       (policy == LIST_CACHE_LFU && model[i].hit_count < model[victim].hit_count) ||
+       ((policy == LIST_CACHE_LRU || model[i].hit_count == model[victim].hit_count) && model[i].last_use < model[victim].last_use)) victim = i;
+  }
+  return (victim < 0) ? keep : victim;
+}
+
+static void run_model( unsigned int seed, int num_of_round )
+{
+  vector<model_entry_t> model;
+  list_cache_stats_t stats;
+  list_cache_pt cache;
+  entry_t element, *found;
+  model_entry_t new_entry;
+  int round, step, policy, max_entries, range, op, i, keep;
+  size_t max_bytes, num_of_bytes;
+  long tick, evict_count;
+
+  srand(seed);
+  for(round = 0; round < num_of_round; round++)
+  {
+    policy = (round & 1) ? LIST_CACHE_LFU : LIST_CACHE_LRU;
+    max_entries = rand() % 12;
+    max_bytes = (round & 2) ? rand() % 40 : 0;
+    range = rand() % 40 + 1;
+    cache = mylistcache_create(policy, max_entries, &entry_copy, &element_free, &entry_compare, &entry_hash, &element_print);
+    if(max_bytes > 0) mylistcache_set_max_bytes(cache, max_bytes, &element_size);
+    model.clear();
+    num_of_bytes = 0;
+    evict_count = 0;
+    for(step = 0, tick = 0; step < 2000; step++, tick++)
+    {
+      element.key = rand() % range;
+      element.value = rand();
+      i = model_find(model, element.key);
+      op = rand() % 10;
+      if(op < 4)
+      {
+        found = (entry_t *)mylistcache_get(cache, &element);
+        CHECK(list_errno == LIST_NO_ERROR);
+        CHECK((found != NULL) == (i >= 0));
+        if(i >= 0)
+        {
+          CHECK(found->value == model[i].value);
+          model[i].hit_count++;
+          model[i].last_use = tick;
+        }
+      }
+      else if(op < 5)
+      {
+        found = (entry_t *)mylistcache_peek(cache, &element);
+        CHECK((found != NULL) == (i >= 0));
+      }
+      else if(op < 9)
+      {
+        CHECK(mylistcache_put(cache, &element) == cache && list_errno == LIST_NO_ERROR);
+        if(i >= 0)
+        {
+          num_of_bytes -= element_size(&element);
+          model.erase(model.begin() + i);
+        }
+        new_entry.key = element.key;
+        new_entry.value = element.value;
+        new_entry.hit_count = 0;
+        new_entry.last_use = tick;
+        model.push_back(new_entry);
+        num_of_bytes += element_size(&element);
+        while(!model.empty() && ((max_entries > 0 && (int)model.size() > max_entries) || (max_bytes > 0 && num_of_bytes > max_bytes)))
+        {
+          keep = model_find(model, element.key);
+          i = model_victim(model, policy, keep);
+          num_of_bytes -= element_size(&model[i]);
+          model.erase(model.begin() + i);
+          evict_count++;
+        }
+      }
+      else if(rand() & 1)
+      {
+        CHECK(mylistcache_erase(cache, &element) == cache);
+        if(i >= 0)
+        {
+          num_of_bytes -= element_size(&element);
+          model.erase(model.begin() + i);
+        }
+      }
+      else
+      {
+        CHECK(mylistcache_evict(cache) == cache);
+        CHECK(list_errno == (model.empty() ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        if(!model.empty())
+        {
+          i = model_victim(model, policy, -1);
+          num_of_bytes -= element_size(&model[i]);
+          model.erase(model.begin() + i);
+          evict_count++;
+        }
+      }
+      CHECK(mylistcache_size(cache) == (int)model.size());
+    }
+    mylistcache_stats(cache, &stats);
+    CHECK(stats.evict_count == evict_count);
+    mylistcache_free(&cache);
+    CHECK(cache == NULL && list_errno == LIST_NO_ERROR);
+  }
+}
+
+static void check_new_keys_are_kept( void )
+{
+  list_cache_pt cache;
+  entry_t element = { 0, 0 };
+  int round = 0, policy, key;
+
+  //cap 3, keys 1..3 used once: a new key is never the one evicted by its own put
+  for(policy = LIST_CACHE_LRU; policy <= LIST_CACHE_LFU; policy++)
+  {
+    cache = mylistcache_create(policy, 3, &entry_copy, &element_free, &entry_compare, &entry_hash, NULL);
+    for(key = 1; key <= 3; key++) { element.key = key; mylistcache_put(cache, &element); }
+    for(key = 1; key <= 3; key++) { element.key = key; CHECK(mylistcache_get(cache, &element) != NULL); }
+    element.key = 4;
+    mylistcache_put(cache, &element);
+    CHECK(mylistcache_size(cache) == 3 && mylistcache_peek(cache, &element) != NULL);
+    element.key = 1;
+    CHECK(mylistcache_peek(cache, &element) == NULL);
+    element.key = 5;
+    mylistcache_put(cache, &element);
+    CHECK(mylistcache_size(cache) == 3 && mylistcache_peek(cache, &element) != NULL);
+    //LRU evicts 2, the least recently used; LFU evicts 4, the only key without a hit
+    element.key = 4;
+    CHECK((mylistcache_peek(cache, &element) != NULL) == (policy == LIST_CACHE_LRU));
+    element.key = 2;
+    CHECK((mylistcache_peek(cache, &element) != NULL) == (policy == LIST_CACHE_LFU));
+    element.key = 3;
+    CHECK(mylistcache_peek(cache, &element) != NULL);
+
+    //replacing a cached key keeps one entry with the new value
+    element.key = 5;
+    element.value = 55;
+    CHECK(mylistcache_put(cache, &element) == cache && mylistcache_size(cache) == 3);
+    CHECK(((entry_t *)mylistcache_get(cache, &element))->value == 55);
+    mylistcache_free(&cache);
+  }
+
+  //an element bigger than the byte limit alone is not kept
+  cache = mylistcache_create(LIST_CACHE_LFU, 0, &entry_copy, &element_free, &entry_compare, &entry_hash, NULL);
+  mylistcache_set_max_bytes(cache, 3, &element_size);
+  element.key = 1;
+  mylistcache_put(cache, &element);
+  element.key = 6;
+  CHECK(mylistcache_put(cache, &element) == cache && mylistcache_size(cache) == 0);
+  mylistcache_free(&cache);
+}
+
+static void run_benchmark( int n )
+{
+  list_pt list;
+  list_cache_pt cache;
+  list_elm_pt element;
+  int i, key, index, policy, num_of_op = (n >= 10000) ? 20000 : 200000, num_of_get = 2000000;
+  long hit_count = 0;
+  double start, plain, hit, mixed;
+
+  //the plain list: find the element, move it to the front
+  list = mylist_create(&entry_copy, &element_free, &entry_compare, NULL);
+  for(i = 0; i < n; i++)
+  {
+    entry_t e = { i, i };
+    mylist_insert_at_index(list, &e, i);
+  }
+  srand(1);
+  start = now();
+  for(i = 0; i < num_of_op; i++)
+  {
+    entry_t e = { rand() % n, 0 };
+    index = mylist_get_index_of_element(list, &e);
+    element = mylist_get_element_at_index(list, index);
+    mylist_remove_at_index(list, index);
+    mylist_insert_at_index(list, element, 0);
+    element_free(&element);
+  }
+  plain = (now() - start) / num_of_op;
+  mylist_free(&list);
+
+  for(policy = LIST_CACHE_LRU; policy <= LIST_CACHE_LFU; policy++)
+  {
+    cache = mylistcache_create(policy, n, &entry_copy, &element_free, &entry_compare, &entry_hash, NULL);
+    for(i = 0; i < n; i++)
+    {
+      entry_t e = { i, i };
+      mylistcache_put(cache, &e);
+    }
+    srand(1);
+    start = now();
+    for(i = 0; i < num_of_get; i++)
+    {
+      entry_t e = { rand() % n, 0 };
+      hit_count += (mylistcache_get(cache, &e) != NULL);
+    }
+    hit = (now() - start) / num_of_get;
+    //keys from twice the capacity: half of the gets miss and put the key, evicting another one
+    start = now();
+    for(i = 0; i < num_of_get; i++)
+    {
+      key = rand() % (2 * n);
+      entry_t e = { key, key };
+      if(mylistcache_get(cache, &e) == NULL) mylistcache_put(cache, &e);
+    }
+    mixed = (now() - start) / num_of_get;
+    printf("%7d %5s %18.1f %14.1f %18.1f\n", n, (policy == LIST_CACHE_LFU) ? "LFU" : "LRU", plain * 1e9, hit * 1e9, mixed * 1e9);
+    mylistcache_free(&cache);
+  }
+  if(hit_count != 2L * num_of_get) abort();
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_round = (argc > 2) ? atoi(argv[2]) : 400;
+  int n;
+
+  check_new_keys_are_kept();
+  run_model(seed, num_of_round);
+  printf("seed %u: %d rounds match the LRU/LFU model\n", seed, num_of_round);
+
+  printf("ns per operation\n");
+  printf("%7s %5s %18s %14s %18s\n", "n", "cache", "plain list hit", "cache hit", "50% miss get+put");
+  for(n = 100; n <= 10000; n *= 10) run_benchmark(n);
+  return 0;
+}
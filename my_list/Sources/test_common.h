@@ -0,0 +1,81 @@
+//============================================================================
+// Name        : test_common.h
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Helpers shared by the test_*.cpp drivers
+//               list_errno, the CHECK macro, callbacks for lists of int
+//               and the clock of the benchmarks. Each driver is a single
+//               translation unit that includes this file once.
+//============================================================================
+
+#ifndef TEST_COMMON_H_
+#define TEST_COMMON_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "mylist.h"
+
+int list_errno;
+
+/*
+ * Aborts when 'cond' is false. A driver with a round or step counter defines
+ * CHECK_COUNTER as that variable before the include, to print it as well.
+ */
+#define CHECK_STRING(x) #x
+#define CHECK_NAME(x) CHECK_STRING(x)
+
+#ifdef CHECK_COUNTER
+#define CHECK_FAILED(cond) fprintf(stderr, "check '%s' failed in %s %d (line %d)\n", cond, CHECK_NAME(CHECK_COUNTER), (int)(CHECK_COUNTER), __LINE__)
+#else
+#define CHECK_FAILED(cond) fprintf(stderr, "check '%s' failed at line %d\n", cond, __LINE__)
+#endif
+
+#define CHECK(cond)          \
+  do {                       \
+    if(!(cond)) {            \
+      CHECK_FAILED(#cond);   \
+      abort();               \
+    }                        \
+  } while(0)
+
+/*
+ * Callbacks for lists of int, each element in its own allocation
+ */
+static inline void element_copy(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  int *copy = (int *)malloc(sizeof(int));
+  if(copy != NULL) *copy = *(int *)src_element;
+  *dest_element = copy;
+}
+
+static inline void element_free(list_elm_pt *element)
+{
+  free(*element);
+  *element = NULL;
+}
+
+static inline int element_compare(list_elm_pt x, list_elm_pt y)
+{
+  if(*(int *)x < *(int *)y) { return -1; }
+  if(*(int *)x > *(int *)y) { return 1; }
+  return 0;
+}
+
+static inline unsigned long element_hash(list_elm_pt x)
+{
+  return (unsigned long)(*(int *)x) * 2654435761u;
+}
+
+/*
+ * Monotonic time in seconds
+ */
+static inline double now( void )
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#endif  //TEST_COMMON_H_
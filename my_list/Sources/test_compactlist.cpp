@@ -0,0 +1,304 @@
+//============================================================================
+// Name        : test_compactlist.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of mycompactlist.cpp
+//               Runs random operations against a std::list model, saves
+//               and loads the list, attaches to an mmap'ed image, checks
+//               that corrupted images are rejected, then compares memory
+//               footprint and traversal time with mylist.
+//
+//               Build: g++ -O2 test_compactlist.cpp mycompactlist.cpp mylist.cpp -o test_compactlist
+//               Usage: test_compactlist [seed] [number of elements for the benchmark]
+//============================================================================
+
+#include <string.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <list>
+#include <vector>
+#include "mycompactlist.h"
+#include "test_common.h"
+using namespace std;
+
+//offsets of the saved header fields (all uint32_t)
+enum { HDR_ELEMENT_SIZE = 4, HDR_NODE_SIZE = 8, HDR_HEAD = 12, HDR_TAIL = 16, HDR_FREE_HEAD = 20, HDR_NUM_OF_ELEMENT = 24, HDR_USED = 28, HDR_SIZE = 32 };
+
+static void check_equal( compact_list_pt list, const std::list<int> &model )
+{
+  std::list<int>::const_iterator it = model.begin();
+  compact_ref_t ref;
+
+  CHECK(mycompactlist_size(list) == (int)model.size());
+  for(ref = mycompactlist_get_first_reference(list); ref != COMPACT_NIL; ref = mycompactlist_get_next_reference(list, ref))
+  {
+    CHECK(it != model.end() && *(int *)mycompactlist_get_element_at_reference(list, ref) == *it);
+    ++it;
+  }
+  CHECK(it == model.end());
+}
+
+static vector<unsigned char> save_image( compact_list_pt list )
+{
+  FILE *fp = tmpfile();
+  vector<unsigned char> image;
+  long size;
+
+  CHECK(mycompactlist_save(list, fp) == list);
+  size = ftell(fp);
+  image.resize(size);
+  rewind(fp);
+  CHECK(fread(&image[0], 1, size, fp) == (size_t)size);
+  fclose(fp);
+  return image;
+}
+
+static compact_list_pt load_image( const vector<unsigned char> &image )
+{
+  FILE *fp = tmpfile();
+  compact_list_pt list;
+
+  fwrite(&image[0], 1, image.size(), fp);
+  rewind(fp);
+  list = mycompactlist_load(fp, &element_compare, NULL);
+  fclose(fp);
+  return list;
+}
+
+static void set_field( vector<unsigned char> &image, int offset, uint32_t value )
+{
+  memcpy(&image[offset], &value, sizeof(uint32_t));
+}
+
+static void check_rejected( vector<unsigned char> image )
+{
+  CHECK(load_image(image) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(mycompactlist_attach(&image[0], image.size(), &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+}
+
+static void run_model( unsigned int seed )
+{
+  compact_list_pt list = mycompactlist_create(sizeof(int), &element_compare, NULL);
+  std::list<int> model;
+  std::list<int>::iterator it;
+  int step, n, index, value, i, found, *element;
+
+  srand(seed);
+  for(step = 0; step < 200000; step++)
+  {
+    n = (int)model.size();
+    index = rand() % (n + 5) - 2;
+    value = rand() % 50;
+    it = model.begin();
+    switch(rand() % 6)
+    {
+      case 0:
+      case 1:
+        CHECK(mycompactlist_insert_at_index(list, &value, index) == list);
+        advance(it, (index <= 0) ? 0 : (index > n) ? n : index);
+        model.insert(it, value);
+        break;
+      case 2:
+        mycompactlist_remove_at_index(list, index);
+        CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        if(n == 0) break;
+        advance(it, (index < 0) ? 0 : (index >= n) ? n-1 : index);
+        model.erase(it);
+        break;
+      case 3:
+        element = (int *)mycompactlist_get_element_at_index(list, index);
+        CHECK((element == NULL) == (n == 0));
+        //the _r form gives the same element and leaves list_errno alone
+        list_errno = -1;
+        CHECK(mycompactlist_get_element_at_index_r(list, index, (list_elm_pt *)&element) == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        CHECK(list_errno == -1 && (element == NULL) == (n == 0));
+        if(n == 0) break;
+        advance(it, (index < 0) ? 0 : (index >= n) ? n-1 : index);
+        CHECK(*element == *it);
+        break;
+      case 4:
+        found = -1;
+        i = 0;
+        for(it = model.begin(); it != model.end(); ++it, i++)
+        {
+          if(*it == value) { found = i; break; }
+        }
+        CHECK(mycompactlist_get_index_of_element(list, &value) == found);
+        list_errno = -1;
+        CHECK(mycompactlist_get_index_of_element_r(list, &value, &i) == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR) && i == found);
+        CHECK(mycompactlist_size_r(list, &i) == LIST_NO_ERROR && i == n && list_errno == -1);
+        break;
+      case 5:
+        check_equal(list, model);
+        break;
+    }
+    //keep the list short, so removed nodes are chained in the free list
+    if(model.size() > 300)
+    {
+      while(model.size() > 100)
+      {
+        mycompactlist_remove_at_index(list, 0);
+        model.pop_front();
+      }
+    }
+  }
+  check_equal(list, model);
+  mycompactlist_free(&list);
+  CHECK(list == NULL);
+  CHECK(mycompactlist_size(NULL) == -1 && list_errno == LIST_INVALID_ERROR);
+  list_errno = -1;
+  CHECK(mycompactlist_size_r(NULL, &n) == LIST_INVALID_ERROR && list_errno == -1);
+}
+
+static void check_images( void )
+{
+  compact_list_pt list, copy;
+  std::list<int> model;
+  vector<unsigned char> image, bad;
+  unsigned char *mapped;
+  FILE *fp;
+  int i, value;
+
+  CHECK(mycompactlist_create(0, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(mycompactlist_create(-4, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+
+  //a list with removed nodes in its free chain survives save/load
+  list = mycompactlist_create(sizeof(int), &element_compare, NULL);
+  for(i = 0; i < 40; i++) mycompactlist_insert_at_index(list, &i, i);
+  for(i = 0; i < 40; i++) model.push_back(i);
+  for(i = 0; i < 10; i++)
+  {
+    mycompactlist_remove_at_index(list, i*2);
+    std::list<int>::iterator it = model.begin();
+    advance(it, i*2);
+    model.erase(it);
+  }
+  image = save_image(list);
+  copy = load_image(image);
+  CHECK(copy != NULL);
+  check_equal(copy, model);
+  value = 1000;
+  mycompactlist_insert_at_index(copy, &value, 3); // reuses a node of the loaded free chain
+  mycompactlist_free(&copy);
+
+  //attach to the file mmap'ed in place: reads and node reuse write to the mapping, growing copies it first
+  fp = tmpfile();
+  CHECK(mycompactlist_save(list, fp) == list);
+  fflush(fp);
+  mapped = (unsigned char *)mmap(NULL, image.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+  CHECK(mapped != MAP_FAILED);
+  copy = mycompactlist_attach(mapped, image.size(), &element_compare, NULL);
+  CHECK(copy != NULL);
+  check_equal(copy, model);
+  for(i = 0; i < 100; i++)
+  {
+    value = 2000 + i;
+    CHECK(mycompactlist_insert_at_index(copy, &value, 5) == copy);
+    std::list<int>::iterator it = model.begin();
+    advance(it, 5);
+    model.insert(it, value);
+  }
+  check_equal(copy, model);
+  mycompactlist_free(&copy);
+  munmap(mapped, image.size());
+  fclose(fp);
+  CHECK(mycompactlist_attach(&image[0], image.size() - 1, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(mycompactlist_attach(&image[1], image.size() - 1, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  mycompactlist_free(&list);
+
+  //corrupted images of a 3-node list are rejected
+  list = mycompactlist_create(sizeof(int), &element_compare, NULL);
+  for(i = 0; i < 3; i++) mycompactlist_insert_at_index(list, &i, i);
+  image = save_image(list);
+  mycompactlist_free(&list);
+  bad = image; set_field(bad, 0, 0); check_rejected(bad);
+  bad = image; set_field(bad, HDR_HEAD, 500); check_rejected(bad);
+  bad = image; set_field(bad, HDR_TAIL, 3); check_rejected(bad);
+  bad = image; set_field(bad, HDR_FREE_HEAD, 7); check_rejected(bad);
+  bad = image; set_field(bad, HDR_NUM_OF_ELEMENT, 4); check_rejected(bad);
+  bad = image; set_field(bad, HDR_NUM_OF_ELEMENT, 2); check_rejected(bad);
+  bad = image; set_field(bad, HDR_ELEMENT_SIZE, 0); check_rejected(bad);
+  bad = image; set_field(bad, HDR_NODE_SIZE, 8); check_rejected(bad);
+  bad = image; set_field(bad, HDR_USED, 1000); check_rejected(bad);
+  bad = image; set_field(bad, HDR_SIZE + 4, 500); check_rejected(bad);     // next of node 0 out of the array
+  bad = image; set_field(bad, HDR_SIZE + 12 + 4, 0); check_rejected(bad);  // next of node 1 back to node 0
+  bad = image; set_field(bad, HDR_FREE_HEAD, 1); check_rejected(bad);      // free chain into the linked nodes
+
+  //random corruption: either rejected or a list that can be walked
+  srand(7);
+  for(i = 0; i < 20000; i++)
+  {
+    bad = image;
+    bad[rand() % bad.size()] = (unsigned char)rand();
+    if(rand() % 2) bad[rand() % bad.size()] = (unsigned char)rand();
+    copy = load_image(bad);
+    if(copy == NULL) continue;
+    CHECK(mycompactlist_size(copy) <= 3);
+    mycompactlist_remove_at_index(copy, 1);
+    mycompactlist_insert_at_index(copy, &i, 1);
+    mycompactlist_get_element_at_index(copy, 2);
+    mycompactlist_free(&copy);
+  }
+}
+
+static size_t heap_in_use( void )
+{
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+static void long_copy(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  long *copy = (long *)malloc(sizeof(long));
+  if(copy != NULL) *copy = *(long *)src_element;
+  *dest_element = copy;
+}
+
+static void run_benchmark( int n )
+{
+  list_pt list;
+  compact_list_pt compact;
+  list_node_pt node;
+  compact_ref_t ref;
+  size_t before, middle, after;
+  double start, linked, packed;
+  long i, sum = 0, sum2 = 0;
+
+  before = heap_in_use();
+  list = mylist_create(&long_copy, &element_free, NULL, NULL);
+  for(i = 0; i < n; i++) mylist_insert_at_index(list, &i, n);
+  middle = heap_in_use();
+  compact = mycompactlist_create(sizeof(long), NULL, NULL);
+  for(i = 0; i < n; i++) mycompactlist_insert_at_index(compact, &i, n);
+  after = heap_in_use();
+
+  start = now();
+  for(node = mylist_get_reference_at_index(list, 0); node != NULL; node = mylist_get_next_reference(node)) sum += *(long *)mylist_get_element_at_reference(node);
+  linked = now() - start;
+  start = now();
+  for(ref = mycompactlist_get_first_reference(compact); ref != COMPACT_NIL; ref = mycompactlist_get_next_reference(compact, ref)) sum2 += *(long *)mycompactlist_get_element_at_reference(compact, ref);
+  packed = now() - start;
+  CHECK(sum == sum2);
+
+  printf("%d longs: heap bytes/element mylist %.1f, compact %.1f (with unused array capacity)\n", n,
+         (double)(middle - before) / n, (double)(after - middle) / n);
+  printf("full traversal: mylist %.1f ms, compact %.1f ms\n", linked * 1e3, packed * 1e3);
+  mylist_free(&list);
+  mycompactlist_free(&compact);
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int n = (argc > 2) ? atoi(argv[2]) : 10000000;
+
+  run_model(seed);
+  printf("seed %u: compact list matches the std::list model\n", seed);
+  check_images();
+  printf("save/load, attach and corrupted images checked\n");
+  if(n > 0) run_benchmark(n);
+  return 0;
+}
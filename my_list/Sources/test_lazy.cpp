@@ -0,0 +1,254 @@
+//============================================================================
+// Name        : test_lazy.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of lazy removal (mylist_set_lazy_removal)
+//               Random sequences of inserts, index and element removes,
+//               lookups, reference walks, compaction and the operations that
+//               compact first are run with tombstone ratios from 0 (off) to
+//               2 (compact by hand) and checked against a std::vector model.
+//               Then a burst of removes by element is timed against the
+//               index_of + free_at_index it replaces, eager and lazy, with
+//               the traversal cost while the tombstones are still linked.
+//
+//               Build: g++ -O2 test_lazy.cpp mylist.cpp -o test_lazy
+//               Usage: test_lazy [seed] [number of rounds] [benchmark size]
+//============================================================================
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#define CHECK_COUNTER round
+#include "test_common.h"
+using namespace std;
+
+static void shuffle_values( vector<int> &values )
+{
+  for(int i = (int)values.size() - 1; i > 0; i--) swap(values[i], values[rand() % (i + 1)]);
+}
+
+static vector<int> list_values( list_pt list )
+{
+  vector<int> values(mylist_size(list) + 1);
+  values.resize(mylist_to_array(list, &values[0], (int)values.size(), sizeof(int)));
+  return values;
+}
+
+static vector<int> first_occurrences( const vector<int> &values )
+{
+  vector<int> result;
+  set<int> seen;
+  for(size_t i = 0; i < values.size(); i++)
+  {
+    if(seen.insert(values[i]).second) result.push_back(values[i]);
+  }
+  return result;
+}
+
+static void run_model( unsigned int seed, int num_of_round )
+{
+  double ratios[] = { 0, 0.1, 0.5, 0.9, 2 };
+  vector<int> model, other_model, kept;
+  vector<int>::iterator found;
+  list_pt list, other;
+  list_node_pt reference, node;
+  list_elm_pt element;
+  int round, step, range, n, op, value, index, clamped, i;
+
+  srand(seed);
+  for(round = 0; round < num_of_round; round++)
+  {
+    range = rand() % 50 + 2;
+    model.clear();
+    if(round & 1)
+    {
+      n = rand() % 50;
+      for(i = 0; i < n; i++) model.push_back(rand() % range);
+      list = mylist_create_from_array(n > 0 ? &model[0] : NULL, n, sizeof(int), &element_copy, &element_free, &element_compare, NULL);
+    }
+    else list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+    CHECK(mylist_set_lazy_removal_r(list, ratios[round % 5]) == LIST_NO_ERROR);
+
+    for(step = 0; step < 2000; step++)
+    {
+      op = rand() % 14;
+      value = rand() % range;
+      index = rand() % 70 - 5;
+      n = (int)model.size();
+      clamped = (index < 0) ? 0 : (index >= n) ? n - 1 : index;
+      found = find(model.begin(), model.end(), value);
+      switch(op)
+      {
+        case 0:
+        case 1:
+          mylist_insert_at_index(list, &value, index);
+          model.insert(model.begin() + ((index <= 0) ? 0 : (index > n) ? n : index), value);
+          break;
+        case 2:
+          if(n == 0) break;
+          element = mylist_get_element_at_index(list, index);
+          CHECK(*(int *)element == model[clamped]);
+          mylist_remove_at_index(list, index);
+          element_free(&element);
+          model.erase(model.begin() + clamped);
+          break;
+        case 3:
+          mylist_free_at_index(list, index);
+          if(n > 0) model.erase(model.begin() + clamped);
+          break;
+        case 4:
+          //remove doesn't free the element: get it first
+          element = (found != model.end()) ? mylist_get_element_at_index(list, (int)(found - model.begin())) : NULL;
+          mylist_remove_element(list, &value);
+          CHECK(list_errno == ((n > 0) ? LIST_NO_ERROR : LIST_EMPTY_ERROR));
+          element_free(&element);
+          if(found != model.end()) model.erase(found);
+          break;
+        case 5:
+        case 6:
+          CHECK(mylist_free_element_r(list, &value) == ((n > 0) ? LIST_NO_ERROR : LIST_EMPTY_ERROR));
+          if(found != model.end()) model.erase(found);
+          break;
+        case 7:
+          CHECK(mylist_get_index_of_element(list, &value) == ((found == model.end()) ? -1 : (int)(found - model.begin())));
+          break;
+        case 8:
+          //the references skip the tombstones in both directions
+          if(n == 0) break;
+          reference = mylist_get_reference_at_index(list, index);
+          for(node = reference, i = clamped; i < n; i++, node = mylist_get_next_reference(node)) CHECK(*(int *)mylist_get_element_at_reference(node) == model[i]);
+          CHECK(node == NULL);
+          for(node = reference, i = clamped; i >= 0; i--, node = mylist_get_previous_reference(node)) CHECK(*(int *)mylist_get_element_at_reference(node) == model[i]);
+          CHECK(node == NULL);
+          break;
+        case 9:
+          CHECK(mylist_size(list) == n && list_values(list) == model);
+          break;
+        case 10:
+          if(rand() % 10 == 0) CHECK(mylist_compact_r(list) == LIST_NO_ERROR && list_values(list) == model);
+          break;
+        case 11:
+          if(rand() % 20 == 0)
+          {
+            mylist_sort(list);
+            stable_sort(model.begin(), model.end());
+          }
+          break;
+        case 12:
+          if(rand() % 20 == 0)
+          {
+            mylist_unique(list);
+            model = first_occurrences(model);
+          }
+          break;
+        case 13:
+          if(rand() % 20 != 0) break;
+          //a second list with a tombstone of its own
+          other = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+          other_model.clear();
+          for(i = 0; i < 5; i++)
+          {
+            value = rand() % range;
+            mylist_insert_at_index(other, &value, i);
+            other_model.push_back(value);
+          }
+          mylist_set_lazy_removal(other, 0.9);
+          mylist_free_element(other, &other_model[0]);
+          other_model.erase(other_model.begin());
+          if(rand() % 2)
+          {
+            mylist_difference(list, other);
+            for(i = 0, kept.clear(); i < (int)model.size(); i++)
+            {
+              if(find(other_model.begin(), other_model.end(), model[i]) == other_model.end()) kept.push_back(model[i]);
+            }
+            model = kept;
+          }
+          else
+          {
+            mylist_union(list, other);
+            model.insert(model.end(), other_model.begin(), other_model.end());
+            model = first_occurrences(model);
+          }
+          mylist_free(&other);
+          break;
+      }
+    }
+    CHECK(list_values(list) == model);
+    //turning lazy removal off compacts
+    CHECK(mylist_set_lazy_removal_r(list, 0) == LIST_NO_ERROR && list_values(list) == model);
+    mylist_free(&list);
+  }
+  round = num_of_round;
+  list_errno = LIST_NO_ERROR;
+  CHECK(mylist_set_lazy_removal_r(NULL, 0.5) == LIST_INVALID_ERROR && list_errno == LIST_NO_ERROR);
+  mylist_set_lazy_removal(NULL, 0.5);
+  CHECK(list_errno == LIST_INVALID_ERROR);
+}
+
+static void run_benchmark( int n )
+{
+  const char *names[] = { "index_of + free_at_index", "free_element, eager", "free_element, lazy 0.25", "free_element, lazy 2" };
+  vector<int> values(n), burst, out(n);
+  list_pt list;
+  int i, mode, num_of_burst = n / 4, num_of_get = 20000;
+  long sum = 0;
+  double start, removes, traversal, get, compact = 0;
+
+  for(i = 0; i < n; i++) values[i] = i;
+  srand(3);
+  shuffle_values(values);
+  burst.assign(values.begin(), values.begin() + num_of_burst);
+  shuffle_values(burst);
+
+  printf("burst of %d removes by element from a list of %d\n", num_of_burst, n);
+  printf("%-26s %16s %14s %14s %12s\n", "", "k removes/s", "to_array us", "get_at us", "compact us");
+  for(mode = 0; mode < 4; mode++)
+  {
+    list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+    for(i = 0; i < n; i++) mylist_insert_at_index(list, &values[i], i);
+    if(mode == 2) mylist_set_lazy_removal(list, 0.25);
+    if(mode == 3) mylist_set_lazy_removal(list, 2);
+
+    start = now();
+    for(i = 0; i < num_of_burst; i++)
+    {
+      if(mode == 0) mylist_free_at_index(list, mylist_get_index_of_element(list, &burst[i]));
+      else mylist_free_element(list, &burst[i]);
+    }
+    removes = now() - start;
+
+    //steady state: the tombstones of ratio 2 are still linked
+    start = now();
+    for(i = 0; i < 200; i++) mylist_to_array(list, &out[0], n, sizeof(int));
+    traversal = (now() - start) / 200;
+    start = now();
+    for(i = 0; i < num_of_get; i++) sum += *(int *)mylist_get_element_at_index(list, rand() % (n - num_of_burst));
+    get = (now() - start) / num_of_get;
+    if(mode == 3)
+    {
+      start = now();
+      mylist_compact(list);
+      compact = now() - start;
+    }
+    if(mylist_size(list) != n - num_of_burst) abort();
+    printf("%-26s %16.0f %14.1f %14.2f", names[mode], num_of_burst / removes / 1e3, traversal * 1e6, get * 1e6);
+    if(mode == 3) printf(" %12.0f\n", compact * 1e6);
+    else printf(" %12s\n", "-");
+    mylist_free(&list);
+  }
+  if(sum < 0) abort();
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_round = (argc > 2) ? atoi(argv[2]) : 400;
+  int n = (argc > 3) ? atoi(argv[3]) : 20000;
+
+  run_model(seed, num_of_round);
+  printf("seed %u: %d rounds match the std::vector model\n", seed, num_of_round);
+  if(n >= 4) run_benchmark(n);
+  return 0;
+}
@@ -0,0 +1,130 @@
+//============================================================================
+// Name        : test_nodecache.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of the per-thread node cache of mylist
+//               1..N threads each churn inserts and removes on their own
+//               list and check its size; the allocation throughput is
+//               printed per thread count. Build it once with and once
+//               without -DLIST_NODE_CACHE to compare against malloc/free.
+//               With the cache, the statistics are checked and printed,
+//               and nodes freed by exited threads must come back through
+//               the shared depot.
+//
+//               Build: g++ -O2 -pthread [-DLIST_NODE_CACHE] test_nodecache.cpp mylist.cpp -o test_nodecache
+//               Usage: test_nodecache [max threads] [operations per thread]
+//============================================================================
+
+#include <pthread.h>
+#include "test_common.h"
+
+typedef struct churn {
+  pthread_t thread;
+  long num_of_op;
+  unsigned int seed;
+} churn_t;
+
+static void element_borrow(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  *dest_element = src_element; // elements are not owned, only the nodes are allocated
+}
+
+static void element_forget(list_elm_pt *element)
+{
+  *element = NULL;
+}
+
+static void *churn_list( void *arg )
+{
+  churn_t *churn = (churn_t *)arg;
+  unsigned int x = churn->seed;
+  list_pt list;
+  long i;
+  int size = 0, n;
+
+  CHECK(mylist_create_r(&list, &element_borrow, &element_forget, NULL, NULL) == LIST_NO_ERROR);
+  for(i = 0; i < churn->num_of_op; i++)
+  {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    //the list size wanders between 32 and 256 nodes, inserts and removes at both ends
+    if(size < 32 || ((x & 1) && size < 256))
+    {
+      CHECK(mylist_insert_at_index_r(list, (list_elm_pt)&churn->seed, ((x >> 8) & 1) ? 0 : size) == LIST_NO_ERROR);
+      size++;
+    }
+    else
+    {
+      CHECK(mylist_remove_at_index_r(list, ((x >> 8) & 1) ? 0 : size) == LIST_NO_ERROR);
+      size--;
+    }
+  }
+  CHECK(mylist_size_r(list, &n) == LIST_NO_ERROR && n == size);
+  CHECK(mylist_free_r(&list) == LIST_NO_ERROR);
+  return NULL;
+}
+
+static double run_threads( int num_of_threads, long num_of_op )
+{
+  churn_t churns[64];
+  double start = now();
+  int i;
+
+  for(i = 0; i < num_of_threads; i++)
+  {
+    churns[i].num_of_op = num_of_op;
+    churns[i].seed = (unsigned int)i + 1;
+    CHECK(pthread_create(&churns[i].thread, NULL, churn_list, &churns[i]) == 0);
+  }
+  for(i = 0; i < num_of_threads; i++) pthread_join(churns[i].thread, NULL);
+  return now() - start;
+}
+
+int main( int argc, char *argv[] )
+{
+  int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+  long num_of_op = (argc > 2) ? atol(argv[2]) : 2000000;
+  int num_of_threads;
+  double seconds;
+
+  if(max_threads < 1) max_threads = 1;
+  if(max_threads > 64) max_threads = 64;
+#ifdef LIST_NODE_CACHE
+  printf("per-thread node cache\n");
+#else
+  printf("malloc/free\n");
+#endif
+  printf("%8s %16s\n", "threads", "Mops/s total");
+  for(num_of_threads = 1; num_of_threads <= max_threads; num_of_threads *= 2)
+  {
+    seconds = run_threads(num_of_threads, num_of_op);
+    printf("%8d %16.1f\n", num_of_threads, num_of_op * num_of_threads / seconds / 1e6);
+  }
+
+#ifdef LIST_NODE_CACHE
+  {
+    list_node_cache_stats_t before, after;
+    list_pt list;
+    int i;
+
+    //all churn threads have exited: their stats are merged and their magazines are in the depot
+    mylist_node_cache_stats(&before);
+    CHECK(before.alloc_count > 0 && before.hit_count <= before.alloc_count);
+    CHECK(before.hit_rate >= 0 && before.hit_rate <= 1);
+    printf("requests %ld, hits %ld (hit rate %.3f), depot batches got %ld, put %ld, nodes freed %ld\n",
+           before.alloc_count, before.hit_count, before.hit_rate, before.depot_get_count, before.depot_put_count, before.free_count);
+
+    //the main thread has no cached nodes yet, so its inserts must be served from the depot
+    list = mylist_create(&element_borrow, &element_forget, NULL, NULL);
+    for(i = 0; i < 16; i++) mylist_insert_at_index(list, &i, 0);
+    mylist_node_cache_stats(&after);
+    CHECK(after.depot_get_count > before.depot_get_count);
+    CHECK(after.hit_count - before.hit_count == 16);
+    mylist_free(&list);
+    mylist_node_cache_trim();
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,237 @@
+//============================================================================
+// Name        : test_rope.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of myrope
+//               Random inserts, removes, lookups, splits and concats are
+//               checked against a std::vector model, chunk by chunk through
+//               myrope_get_run. Mass removes (in order and at random) must
+//               leave chunks that are merged, not runs of nearly empty
+//               chunks. Then the rope is timed against mylist for appends,
+//               random inserts, lookups, removes and scans.
+//
+//               Build: g++ -O2 test_rope.cpp myrope.cpp mylist.cpp -o test_rope
+//               Usage: test_rope [seed] [number of operations] [benchmark size]
+//============================================================================
+
+#include <vector>
+#include "myrope.h"
+#include "test_common.h"
+using namespace std;
+
+#define ROPE_CAPACITY (ROPE_CHUNK_BYTES / (int)sizeof(int)) // elements per chunk of an int rope
+
+/*
+ * Compares 'rope' with 'model' and returns its number of chunks (one run per chunk)
+ */
+static int check_rope( rope_pt rope, const vector<int> &model )
+{
+  vector<int> array(model.size() + 1);
+  int i, j, n, num_of_chunk = 0;
+  int *run;
+
+  CHECK(myrope_size(rope) == (int)model.size());
+  CHECK(myrope_to_array(rope, &array[0], (int)model.size()) == (int)model.size());
+  for(i = 0; i < (int)model.size(); i++) CHECK(array[i] == model[i]);
+  for(i = 0; i < (int)model.size(); i += n, num_of_chunk++)
+  {
+    run = (int *)myrope_get_run(rope, i, &n);
+    CHECK(n > 0 && n <= ROPE_CAPACITY);
+    for(j = 0; j < n; j++) CHECK(run[j] == model[i + j]);
+  }
+  return num_of_chunk;
+}
+
+static void run_model( unsigned int seed, int num_of_op )
+{
+  rope_pt rope = myrope_create(sizeof(int), &element_compare, NULL), rest;
+  vector<int> model, rest_model;
+  int i, op, n, index, clamped, value;
+
+  srand(seed);
+  for(i = 0; i < num_of_op; i++)
+  {
+    op = rand() % 10;
+    n = (int)model.size();
+    if(op < 5)
+    {
+      index = rand() % (n + 3) - 1;
+      value = rand();
+      CHECK(myrope_insert_at_index(rope, &value, index) == rope);
+      model.insert(model.begin() + ((index < 0) ? 0 : (index > n) ? n : index), value);
+    }
+    else if(op < 8)
+    {
+      index = rand() % (n + 3) - 1;
+      CHECK(myrope_remove_at_index(rope, index) == rope);
+      CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+      if(n > 0) model.erase(model.begin() + ((index < 0) ? 0 : (index >= n) ? n - 1 : index));
+    }
+    else if(op == 8 && n > 0)
+    {
+      index = rand() % n;
+      CHECK(*(int *)myrope_get_element_at_index(rope, index) == model[index]);
+      CHECK(myrope_get_index_of_element(rope, &model[index]) <= index);
+    }
+    else if(op == 9)
+    {
+      //split and concat again, in either order
+      index = rand() % (n + 2) - 1;
+      clamped = (index < 0) ? 0 : (index > n) ? n : index;
+      rest = myrope_split(rope, index);
+      CHECK(rest != NULL);
+      rest_model.assign(model.begin() + clamped, model.end());
+      model.resize(clamped);
+      check_rope(rope, model);
+      check_rope(rest, rest_model);
+      if(rand() % 2)
+      {
+        CHECK(myrope_concat(rope, rest) == rope);
+        model.insert(model.end(), rest_model.begin(), rest_model.end());
+      }
+      else
+      {
+        CHECK(myrope_concat(rest, rope) == rest && myrope_concat(rope, rest) == rope);
+        rest_model.insert(rest_model.end(), model.begin(), model.end());
+        model = rest_model;
+      }
+      CHECK(myrope_size(rest) == 0);
+      myrope_free(&rest);
+      CHECK(rest == NULL);
+    }
+    if(i % 1000 == 0) check_rope(rope, model);
+  }
+  check_rope(rope, model);
+  myrope_free(&rope);
+  CHECK(myrope_concat(NULL, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(myrope_create(0, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(myrope_create(-4, &element_compare, NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+}
+
+static void check_mass_remove( int n )
+{
+  rope_pt rope;
+  vector<int> model;
+  int i, index, num_of_chunk, order;
+
+  for(order = 0; order < 2; order++)
+  {
+    rope = myrope_create(sizeof(int), &element_compare, NULL);
+    for(i = 0; i < n; i++) myrope_insert_at_index(rope, &i, i);
+    model.clear();
+    if(order == 0)
+    {
+      //keep every 256th element, removing from the end
+      for(i = n - 1; i >= 0; i--)
+      {
+        if(i % 256 != 0) myrope_remove_at_index(rope, i);
+      }
+      for(i = 0; i < n; i += 256) model.push_back(i);
+    }
+    else
+    {
+      //remove 255/256 of the elements at random positions: the elements left are still in increasing order
+      for(i = n; i > n / 256; i--)
+      {
+        index = rand() % i;
+        myrope_remove_at_index(rope, index);
+      }
+      model.resize(myrope_size(rope));
+      myrope_to_array(rope, &model[0], (int)model.size());
+      for(i = 1; i < (int)model.size(); i++) CHECK(model[i - 1] < model[i]);
+    }
+    num_of_chunk = check_rope(rope, model);
+    //an underfull chunk only stays next to chunks it doesn't fit in with
+    CHECK(num_of_chunk <= 2 * ((int)model.size() / (ROPE_CAPACITY / 4) + 1));
+    printf("%d of %d elements left %s: %d chunks, %.1f elements per chunk\n", (int)model.size(), n,
+           (order == 0) ? "in order" : "at random", num_of_chunk, (double)model.size() / num_of_chunk);
+    myrope_free(&rope);
+  }
+}
+
+static void run_benchmark( int n, int num_of_op )
+{
+  vector<int> out(n + num_of_op);
+  list_pt list;
+  rope_pt rope;
+  int i, j, m, value, *run;
+  long sum = 0;
+  double start, list_build, list_insert, list_get, list_scan, list_remove;
+  double rope_build, rope_insert, rope_get, rope_scan, rope_run, rope_remove, rope_split;
+
+  srand(5);
+  list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+  start = now();
+  for(i = 0; i < n; i++) mylist_insert_at_index(list, &i, n);
+  list_build = now() - start;
+  start = now();
+  for(i = 0; i < num_of_op; i++) { value = i; mylist_insert_at_index(list, &value, rand() % n); }
+  list_insert = (now() - start) / num_of_op;
+  start = now();
+  for(i = 0; i < num_of_op; i++) sum += *(int *)mylist_get_element_at_index(list, rand() % n);
+  list_get = (now() - start) / num_of_op;
+  start = now();
+  mylist_to_array(list, &out[0], n, sizeof(int));
+  list_scan = now() - start;
+  start = now();
+  for(i = 0; i < num_of_op; i++) mylist_free_at_index(list, rand() % n);
+  list_remove = (now() - start) / num_of_op;
+  mylist_free(&list);
+
+  rope = myrope_create(sizeof(int), &element_compare, NULL);
+  start = now();
+  for(i = 0; i < n; i++) myrope_insert_at_index(rope, &i, n);
+  rope_build = now() - start;
+  start = now();
+  for(i = 0; i < num_of_op; i++) { value = i; myrope_insert_at_index(rope, &value, rand() % n); }
+  rope_insert = (now() - start) / num_of_op;
+  start = now();
+  for(i = 0; i < num_of_op; i++) sum += *(int *)myrope_get_element_at_index(rope, rand() % n);
+  rope_get = (now() - start) / num_of_op;
+  start = now();
+  myrope_to_array(rope, &out[0], n);
+  rope_scan = now() - start;
+  start = now();
+  for(i = 0; i < n; i += m)
+  {
+    run = (int *)myrope_get_run(rope, i, &m);
+    for(j = 0; j < m; j++) sum += run[j];
+  }
+  rope_run = now() - start;
+  start = now();
+  for(i = 0; i < num_of_op; i++) myrope_remove_at_index(rope, rand() % n);
+  rope_remove = (now() - start) / num_of_op;
+  start = now();
+  for(i = 0; i < 1000; i++)
+  {
+    rope_pt rest = myrope_split(rope, rand() % n);
+    myrope_concat(rope, rest);
+    myrope_free(&rest);
+  }
+  rope_split = (now() - start) / 1000;
+  myrope_free(&rope);
+
+  printf("n = %d, %d random operations\n", n, num_of_op);
+  printf("%-16s %14s %14s\n", "", "mylist", "myrope");
+  printf("%-16s %11.1f ms %11.1f ms\n", "build (append)", list_build * 1e3, rope_build * 1e3);
+  printf("%-16s %11.3f us %11.3f us\n", "insert at rand", list_insert * 1e6, rope_insert * 1e6);
+  printf("%-16s %11.3f us %11.3f us\n", "get at rand", list_get * 1e6, rope_get * 1e6);
+  printf("%-16s %11.3f us %11.3f us\n", "remove at rand", list_remove * 1e6, rope_remove * 1e6);
+  printf("%-16s %11.2f ms %11.2f ms (get_run %.2f ms)\n", "scan", list_scan * 1e3, rope_scan * 1e3, rope_run * 1e3);
+  printf("%-16s %14s %11.3f us\n", "split + concat", "-", rope_split * 1e6);
+  if(sum < 0) abort();
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_op = (argc > 2) ? atoi(argv[2]) : 200000;
+  int n = (argc > 3) ? atoi(argv[3]) : 1000000;
+
+  run_model(seed, num_of_op);
+  printf("seed %u: %d operations match the std::vector model\n", seed, num_of_op);
+  check_mass_remove(n);
+  run_benchmark(n, (n >= 100000) ? 2000 : 20000);
+  return 0;
+}
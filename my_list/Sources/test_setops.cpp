@@ -0,0 +1,203 @@
+//============================================================================
+// Name        : test_setops.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of mylist_unique, mylist_intersect,
+//               mylist_difference and mylist_union
+//               Random lists, with and without hash callback, built by
+//               inserts or from arrays, are checked against a std::set
+//               model, including a list combined with itself. Then
+//               intersect is timed against a nested
+//               mylist_get_index_of_element scan.
+//
+//               Build: g++ -O2 test_setops.cpp mylist.cpp -o test_setops
+//               Usage: test_setops [seed] [number of rounds]
+//============================================================================
+
+#include <vector>
+#include <set>
+#define CHECK_COUNTER round
+#include "test_common.h"
+using namespace std;
+
+static list_pt make_list( const vector<int> &values, int use_hash, int from_array )
+{
+  list_pt list;
+  int i;
+
+  if(from_array) list = mylist_create_from_array(values.empty() ? NULL : (list_elm_pt)&values[0], (int)values.size(), sizeof(int), &element_copy, &element_free, &element_compare, NULL);
+  else
+  {
+    list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+    for(i = 0; i < (int)values.size(); i++) mylist_insert_at_index(list, (list_elm_pt)&values[i], i);
+  }
+  if(use_hash) mylist_set_element_hash(list, &element_hash);
+  return list;
+}
+
+static vector<int> list_values( list_pt list )
+{
+  vector<int> values(mylist_size(list) + 1);
+  values.resize(mylist_to_array(list, &values[0], (int)values.size(), sizeof(int)));
+  return values;
+}
+
+static vector<list_elm_pt> list_elements( list_pt list )
+{
+  vector<list_elm_pt> elements;
+  list_node_pt node;
+  for(node = mylist_get_reference_at_index(list, 0); node != NULL && mylist_size(list) > 0; node = mylist_get_next_reference(node)) elements.push_back(mylist_get_element_at_reference(node));
+  return elements;
+}
+
+static vector<int> first_occurrences( const vector<int> &values )
+{
+  vector<int> result;
+  set<int> seen;
+  for(size_t i = 0; i < values.size(); i++)
+  {
+    if(seen.insert(values[i]).second) result.push_back(values[i]);
+  }
+  return result;
+}
+
+static void run_model( unsigned int seed, int num_of_round )
+{
+  int round, i, j, use_hash, from_array, range;
+  vector<int> a, b, expected;
+  vector<list_elm_pt> before, after;
+  list_pt list, other;
+  set<int> in_b;
+
+  srand(seed);
+  for(round = 0; round < num_of_round; round++)
+  {
+    use_hash = round & 1;
+    from_array = (round >> 1) & 1;
+    range = rand() % 30 + 1;
+    a.resize(rand() % 40);
+    b.resize(rand() % 40);
+    for(i = 0; i < (int)a.size(); i++) a[i] = rand() % range;
+    for(i = 0; i < (int)b.size(); i++) b[i] = rand() % range;
+    in_b = set<int>(b.begin(), b.end());
+
+    //unique keeps the first occurrences, by relinking: the kept element pointers don't change
+    list = make_list(a, use_hash, from_array);
+    before = list_elements(list);
+    CHECK(mylist_unique_r(list) == LIST_NO_ERROR);
+    CHECK(list_values(list) == first_occurrences(a));
+    after = list_elements(list);
+    for(i = 0, j = 0; i < (int)after.size(); i++, j++)
+    {
+      while(j < (int)before.size() && before[j] != after[i]) j++;
+      CHECK(j < (int)before.size());
+    }
+    mylist_free(&list);
+
+    //intersect and difference leave 'other' unchanged
+    other = make_list(b, use_hash, !from_array);
+    list = make_list(a, use_hash, from_array);
+    mylist_intersect(list, other);
+    CHECK(list_errno == LIST_NO_ERROR);
+    expected.clear();
+    for(i = 0; i < (int)a.size(); i++) if(in_b.count(a[i])) expected.push_back(a[i]);
+    CHECK(list_values(list) == expected && list_values(other) == b);
+    mylist_free(&list);
+
+    list = make_list(a, use_hash, from_array);
+    mylist_difference(list, other);
+    CHECK(list_errno == LIST_NO_ERROR);
+    expected.clear();
+    for(i = 0; i < (int)a.size(); i++) if(!in_b.count(a[i])) expected.push_back(a[i]);
+    CHECK(list_values(list) == expected && list_values(other) == b);
+    mylist_free(&list);
+
+    //a list combined with itself
+    list = make_list(a, use_hash, from_array);
+    CHECK(mylist_intersect_r(list, list) == LIST_NO_ERROR && list_values(list) == a);
+    CHECK(mylist_union_r(list, list) == LIST_NO_ERROR && list_values(list) == first_occurrences(a));
+    CHECK(mylist_difference_r(list, list) == LIST_NO_ERROR && mylist_size(list) == 0);
+    CHECK(mylist_union_r(list, list) == LIST_NO_ERROR && mylist_size(list) == 0);
+    mylist_insert_at_index(list, &range, 0);
+    mylist_free(&list);
+
+    //union moves the nodes of 'other' and keeps the first occurrences
+    list = make_list(a, use_hash, from_array);
+    mylist_union(list, other);
+    CHECK(list_errno == LIST_NO_ERROR && mylist_size(other) == 0);
+    expected = a;
+    expected.insert(expected.end(), b.begin(), b.end());
+    CHECK(list_values(list) == first_occurrences(expected));
+    //the moved nodes (some from node blocks) can still be removed and reused
+    for(i = 0; i < 5; i++)
+    {
+      mylist_free_at_index(list, rand() % 50);
+      mylist_insert_at_index(list, &i, rand() % 50);
+    }
+    mylist_insert_at_index(other, &range, 0);
+    mylist_free(&list);
+    mylist_free(&other);
+
+    CHECK(mylist_intersect_r(NULL, NULL) == LIST_INVALID_ERROR && mylist_difference_r(NULL, NULL) == LIST_INVALID_ERROR);
+    CHECK(mylist_union_r(NULL, NULL) == LIST_INVALID_ERROR);
+    CHECK(mylist_set_element_hash_r(NULL, &element_hash) == LIST_INVALID_ERROR);
+  }
+}
+
+static void run_benchmark( int n )
+{
+  vector<int> a(n), b(n);
+  list_pt list, other;
+  double start, nested = 0, sorted, hashed;
+  int i, found = 0;
+
+  for(i = 0; i < n; i++) a[i] = rand() % n;
+  for(i = 0; i < n; i++) b[i] = rand() % n;
+
+  if(n <= 10000)
+  {
+    //the baseline: one index_of scan of 'other' per element
+    list = make_list(a, 0, 1);
+    other = make_list(b, 0, 1);
+    start = now();
+    for(i = 0; i < n; i++) found += (mylist_get_index_of_element(other, mylist_get_element_at_index(list, i)) >= 0);
+    nested = now() - start;
+    mylist_free(&list);
+    mylist_free(&other);
+  }
+  list = make_list(a, 0, 1);
+  other = make_list(b, 0, 1);
+  start = now();
+  mylist_intersect(list, other);
+  sorted = now() - start;
+  if(n <= 10000 && mylist_size(list) != found) abort();
+  mylist_free(&list);
+  mylist_free(&other);
+
+  list = make_list(a, 1, 1);
+  other = make_list(b, 1, 1);
+  start = now();
+  mylist_intersect(list, other);
+  hashed = now() - start;
+  mylist_free(&list);
+  mylist_free(&other);
+
+  if(n <= 10000) printf("%9d %14.2f %12.2f %12.2f\n", n, nested * 1e3, sorted * 1e3, hashed * 1e3);
+  else printf("%9d %14s %12.2f %12.2f\n", n, "-", sorted * 1e3, hashed * 1e3);
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_round = (argc > 2) ? atoi(argv[2]) : 3000;
+  int n;
+
+  run_model(seed, num_of_round);
+  printf("seed %u: %d rounds match the std::set model\n", seed, num_of_round);
+
+  printf("intersect of two lists of n random ints (ms)\n");
+  printf("%9s %14s %12s %12s\n", "n", "nested scan", "sort-merge", "hash");
+  for(n = 1000; n <= 1000000; n *= 10) run_benchmark(n);
+  return 0;
+}
@@ -0,0 +1,163 @@
+//============================================================================
+// Name        : test_sort.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of mylist_sort and mylist_sort_parallel
+//               Random, sorted, reverse and duplicate-heavy lists, built by
+//               inserts or from arrays, are sorted with 1..8 threads and
+//               compared with std::stable_sort, forwards and backwards.
+//               Then lists of n elements are timed per thread count, and
+//               every parallel result must equal the sequential one.
+//               Build with -DLIST_PARALLEL -pthread for the parallel sort;
+//               add -DLIST_PARALLEL_MIN=64 to run it on the small test lists.
+//
+//               Build: g++ -O2 -pthread -DLIST_PARALLEL test_sort.cpp mylist.cpp -o test_sort
+//               Usage: test_sort [seed] [number of rounds] [benchmark size]
+//============================================================================
+
+#include <vector>
+#include <algorithm>
+#define CHECK_COUNTER round
+#include "test_common.h"
+using namespace std;
+
+/*
+ * Element sorted by 'key'; 'seq' is its original position, to check stability
+ */
+typedef struct entry {
+  int key;
+  int seq;
+} entry_t;
+
+enum distribution { DIST_RANDOM, DIST_SORTED, DIST_REVERSE, DIST_DUPS, DIST_COUNT };
+static const char *distribution_names[DIST_COUNT] = { "random", "sorted", "reverse", "dups(16)" };
+
+static void entry_copy(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  entry_t *copy = (entry_t *)malloc(sizeof(entry_t));
+  if(copy != NULL) *copy = *(entry_t *)src_element;
+  *dest_element = copy;
+}
+
+static int entry_compare(list_elm_pt x, list_elm_pt y)
+{
+  if(((entry_t *)x)->key < ((entry_t *)y)->key) { return -1; }
+  if(((entry_t *)x)->key > ((entry_t *)y)->key) { return 1; }
+  return 0;
+}
+
+static bool entry_less( const entry_t &x, const entry_t &y )
+{
+  return x.key < y.key;
+}
+
+static void fill( vector<entry_t> &values, int distribution )
+{
+  int i, n = (int)values.size();
+  for(i = 0; i < n; i++)
+  {
+    values[i].key = (distribution == DIST_RANDOM) ? rand() : (distribution == DIST_SORTED) ? i :
+                    (distribution == DIST_REVERSE) ? n - i : rand() % 16;
+    values[i].seq = i;
+  }
+}
+
+static void run_model( unsigned int seed, int num_of_round )
+{
+  vector<entry_t> values, sorted;
+  list_pt list;
+  list_node_pt reference;
+  entry_t *element;
+  int round, i, n, num_of_threads;
+
+  srand(seed);
+  for(round = 0; round < num_of_round; round++)
+  {
+    n = rand() % ((round % 10 == 0) ? 5000 : 300);
+    values.resize(n);
+    fill(values, rand() % DIST_COUNT);
+    num_of_threads = rand() % 9 - 1;
+
+    //lists from arrays have their nodes in blocks, the others one node per allocation
+    if(round & 1) list = mylist_create_from_array(n > 0 ? &values[0] : NULL, n, sizeof(entry_t), &entry_copy, &element_free, &entry_compare, NULL);
+    else
+    {
+      list = mylist_create(&entry_copy, &element_free, &entry_compare, NULL);
+      for(i = 0; i < n; i++) mylist_insert_at_index(list, &values[i], i);
+    }
+    if(round % 3 == 0) CHECK(mylist_sort(list) == list);
+    else CHECK(mylist_sort_parallel(list, num_of_threads) == list);
+    CHECK(list_errno == LIST_NO_ERROR);
+
+    stable_sort(values.begin(), values.end(), entry_less);
+    sorted.resize(n + 1);
+    CHECK(mylist_to_array(list, &sorted[0], n + 1, sizeof(entry_t)) == n);
+    for(i = 0; i < n; i++) CHECK(sorted[i].key == values[i].key && sorted[i].seq == values[i].seq);
+
+    //the previous links and the tail must be right too
+    reference = (n > 0) ? mylist_get_reference_at_index(list, n - 1) : NULL;
+    for(i = n - 1; i >= 0; i--)
+    {
+      element = (entry_t *)mylist_get_element_at_reference(reference);
+      CHECK(element->seq == values[i].seq);
+      reference = mylist_get_previous_reference(reference);
+    }
+    CHECK(reference == NULL);
+    mylist_insert_at_index(list, &values[0], 5);
+    mylist_free_at_index(list, 0);
+    mylist_free(&list);
+  }
+  round = num_of_round;
+  CHECK(mylist_sort(NULL) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(mylist_sort_parallel(NULL, 4) == NULL && list_errno == LIST_INVALID_ERROR);
+  CHECK(mylist_sort_r(NULL) == LIST_INVALID_ERROR);
+}
+
+static void run_benchmark( int n )
+{
+  vector<entry_t> values(n), expected(n), sorted(n);
+  list_pt list;
+  int round = 0, distribution, num_of_threads;
+  double start, seconds;
+
+  printf("sort of %d elements (s)\n", n);
+  printf("%-9s %10s %10s %10s %10s\n", "", "1 thread", "2 threads", "4 threads", "8 threads");
+  for(distribution = 0; distribution < DIST_COUNT; distribution++)
+  {
+    srand(7);
+    fill(values, distribution);
+    printf("%-9s", distribution_names[distribution]);
+    for(num_of_threads = 1; num_of_threads <= 8; num_of_threads *= 2)
+    {
+      list = mylist_create_from_array(&values[0], n, sizeof(entry_t), &entry_copy, &element_free, &entry_compare, NULL);
+      start = now();
+      if(num_of_threads == 1) mylist_sort(list);
+      else mylist_sort_parallel(list, num_of_threads);
+      seconds = now() - start;
+      printf(" %10.3f", seconds);
+      fflush(stdout);
+
+      //every thread count must give the sequential result, element by element
+      CHECK(mylist_to_array(list, num_of_threads == 1 ? &expected[0] : &sorted[0], n, sizeof(entry_t)) == n);
+      if(num_of_threads > 1)
+      {
+        for(int i = 0; i < n; i++) CHECK(sorted[i].key == expected[i].key && sorted[i].seq == expected[i].seq);
+      }
+      mylist_free(&list);
+    }
+    printf("\n");
+  }
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_round = (argc > 2) ? atoi(argv[2]) : 300;
+  int n = (argc > 3) ? atoi(argv[3]) : 2000000;
+
+  run_model(seed, num_of_round);
+  printf("seed %u: %d rounds match std::stable_sort\n", seed, num_of_round);
+  if(n > 0) run_benchmark(n);
+  return 0;
+}
@@ -0,0 +1,192 @@
+//============================================================================
+// Name        : test_sortedlist.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of mysortedlist.cpp
+//               Runs random inserts, removes and queries against a sorted
+//               std::vector model (equal keys keep their insertion order),
+//               then times find/rank against a linear
+//               mylist_get_index_of_element at 10^3..10^6 elements.
+//
+//               Build: g++ -O2 test_sortedlist.cpp mysortedlist.cpp mylist.cpp -o test_sortedlist
+//               Usage: test_sortedlist [seed] [number of operations]
+//============================================================================
+
+#include <vector>
+#include <algorithm>
+#include "mysortedlist.h"
+#define CHECK_COUNTER step
+#include "test_common.h"
+using namespace std;
+
+/*
+ * A key with the order in which it was inserted, to check that equal keys stay in insertion order
+ */
+typedef struct entry {
+  int key;
+  int seq;
+} entry_t;
+
+static void entry_copy(list_elm_pt *dest_element, list_elm_pt src_element)
+{
+  entry_t *copy = (entry_t *)malloc(sizeof(entry_t));
+  if(copy != NULL) *copy = *(entry_t *)src_element;
+  *dest_element = copy;
+}
+
+static int entry_compare(list_elm_pt x, list_elm_pt y)
+{
+  if(((entry_t *)x)->key < ((entry_t *)y)->key) { return -1; }
+  if(((entry_t *)x)->key > ((entry_t *)y)->key) { return 1; }
+  return 0;
+}
+
+static bool model_less( const entry_t &a, const entry_t &b ) { return a.key < b.key; }
+
+static int seq_at( sorted_node_pt reference )
+{
+  return ((entry_t *)mysortedlist_get_element_at_reference(reference))->seq;
+}
+
+static void run_model( unsigned int seed, int num_of_step )
+{
+  sorted_list_pt list = mysortedlist_create(&entry_copy, &element_free, &entry_compare, NULL);
+  vector<entry_t> model;
+  int step, lower, upper, n, i, index;
+  sorted_node_pt reference;
+  entry_t value;
+
+  srand(seed);
+  for(step = 0; step < num_of_step; step++)
+  {
+    value.key = rand() % 200;
+    value.seq = step;
+    n = (int)model.size();
+    lower = (int)(lower_bound(model.begin(), model.end(), value, model_less) - model.begin());
+    upper = (int)(upper_bound(model.begin(), model.end(), value, model_less) - model.begin());
+    switch(rand() % 7)
+    {
+      case 0:
+      case 1:
+        CHECK(mysortedlist_insert(list, &value) == list && list_errno == LIST_NO_ERROR);
+        model.insert(model.begin() + upper, value);
+        break;
+      case 2:
+        CHECK(mysortedlist_insert_unique(list, &value) == list);
+        if(lower == upper) model.insert(model.begin() + upper, value);
+        break;
+      case 3:
+        mysortedlist_free_element(list, &value);
+        CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        if(lower < upper) model.erase(model.begin() + lower);
+        break;
+      case 4:
+        CHECK(mysortedlist_rank(list, &value) == lower);
+        reference = mysortedlist_find(list, &value);
+        CHECK((reference == NULL) == (lower == upper));
+        if(reference != NULL) CHECK(seq_at(reference) == model[lower].seq);
+        reference = mysortedlist_lower_bound(list, &value);
+        CHECK((reference == NULL) == (lower == n));
+        if(reference != NULL) CHECK(seq_at(reference) == model[lower].seq);
+        reference = mysortedlist_upper_bound(list, &value);
+        CHECK((reference == NULL) == (upper == n));
+        if(reference != NULL) CHECK(seq_at(reference) == model[upper].seq);
+
+        //the _r forms give the same answers and leave list_errno alone
+        list_errno = -1;
+        CHECK(mysortedlist_rank_r(list, &value, &i) == LIST_NO_ERROR && i == lower);
+        CHECK(mysortedlist_find_r(list, &value, &reference) == LIST_NO_ERROR && (reference == NULL) == (lower == upper));
+        CHECK(mysortedlist_lower_bound_r(list, &value, &reference) == LIST_NO_ERROR && (reference == NULL) == (lower == n));
+        if(reference != NULL) CHECK(seq_at(reference) == model[lower].seq);
+        CHECK(mysortedlist_upper_bound_r(list, &value, &reference) == LIST_NO_ERROR && (reference == NULL) == (upper == n));
+        if(reference != NULL) CHECK(seq_at(reference) == model[upper].seq);
+        CHECK(mysortedlist_size_r(list, &i) == LIST_NO_ERROR && i == n);
+        CHECK(list_errno == -1);
+        break;
+      case 5:
+      {
+        entry_t *element;
+        index = rand() % (n + 4) - 2;
+        element = (entry_t *)mysortedlist_get_element_at_index(list, index);
+        CHECK((element == NULL) == (n == 0));
+        CHECK(list_errno == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        if(n > 0) CHECK(element->seq == model[(index < 0) ? 0 : (index >= n) ? n-1 : index].seq);
+        list_errno = -1;
+        CHECK(mysortedlist_get_element_at_index_r(list, index, (list_elm_pt *)&element) == ((n == 0) ? LIST_EMPTY_ERROR : LIST_NO_ERROR));
+        CHECK(list_errno == -1);
+        if(n > 0) CHECK(element->seq == model[(index < 0) ? 0 : (index >= n) ? n-1 : index].seq);
+        break;
+      }
+      case 6:
+        //walk the whole list both ways
+        CHECK(mysortedlist_size(list) == n);
+        i = 0;
+        for(reference = mysortedlist_get_first_reference(list); reference != NULL; reference = mysortedlist_get_next_reference(reference))
+        {
+          CHECK(i < n && seq_at(reference) == model[i].seq);
+          i++;
+        }
+        CHECK(i == n);
+        for(reference = mysortedlist_get_last_reference(list); reference != NULL; reference = mysortedlist_get_previous_reference(reference))
+        {
+          i--;
+          CHECK(i >= 0 && seq_at(reference) == model[i].seq);
+        }
+        break;
+    }
+  }
+  mysortedlist_free(&list);
+  CHECK(list == NULL);
+  CHECK(mysortedlist_rank(NULL, &value) == -1 && list_errno == LIST_INVALID_ERROR);
+  CHECK(mysortedlist_find(NULL, &value) == NULL && list_errno == LIST_INVALID_ERROR);
+  list_errno = -1;
+  CHECK(mysortedlist_rank_r(NULL, &value, &i) == LIST_INVALID_ERROR && i == -1);
+  CHECK(mysortedlist_upper_bound_r(NULL, &value, &reference) == LIST_INVALID_ERROR && reference == NULL);
+  CHECK(list_errno == -1);
+}
+
+static void run_benchmark( int n, int num_of_query )
+{
+  sorted_list_pt sorted = mysortedlist_create(&entry_copy, &element_free, &entry_compare, NULL);
+  list_pt list;
+  vector<entry_t> keys(n);
+  double start, linear, find, rank;
+  long sum = 0;
+  int i;
+
+  for(i = 0; i < n; i++)
+  {
+    keys[i].key = rand();
+    keys[i].seq = i;
+  }
+  for(i = 0; i < n; i++) mysortedlist_insert(sorted, &keys[i]);
+  list = mylist_create_from_array(&keys[0], n, sizeof(entry_t), &entry_copy, &element_free, &entry_compare, NULL);
+
+  start = now();
+  for(i = 0; i < num_of_query; i++) sum += mylist_get_index_of_element(list, &keys[rand() % n]);
+  linear = (now() - start) / num_of_query;
+  start = now();
+  for(i = 0; i < num_of_query; i++) sum += (mysortedlist_find(sorted, &keys[rand() % n]) != NULL);
+  find = (now() - start) / num_of_query;
+  start = now();
+  for(i = 0; i < num_of_query; i++) sum += mysortedlist_rank(sorted, &keys[rand() % n]);
+  rank = (now() - start) / num_of_query;
+  printf("%9d %14.2f %10.3f %10.3f   (%ld)\n", n, linear * 1e6, find * 1e6, rank * 1e6, sum & 1);
+  mylist_free(&list);
+  mysortedlist_free(&sorted);
+}
+
+int main( int argc, char *argv[] )
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  int num_of_step = (argc > 2) ? atoi(argv[2]) : 100000;
+  int n;
+
+  run_model(seed, num_of_step);
+  printf("seed %u: %d steps match the sorted std::vector model\n", seed, num_of_step);
+
+  printf("%9s %14s %10s %10s\n", "n", "index_of (us)", "find (us)", "rank (us)");
+  for(n = 1000; n <= 1000000; n *= 10) run_benchmark(n, (n >= 100000) ? 200 : 2000);
+  return 0;
+}
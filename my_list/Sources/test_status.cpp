@@ -0,0 +1,129 @@
+//============================================================================
+// Name        : test_status.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of the status returning mylist_*_r API
+//               Checks that the _r calls return the same results as the
+//               wrappers and never write list_errno, then lets 1..N threads
+//               read one shared list through the wrappers (which store
+//               list_errno on every call) and through the _r calls.
+//
+//               Build: g++ -O2 -pthread test_status.cpp mylist.cpp -o test_status
+//               Usage: test_status [max threads] [calls per thread]
+//============================================================================
+
+#include <pthread.h>
+#include "test_common.h"
+
+#define LIST_ERRNO_UNTOUCHED 12345
+
+typedef struct reader {
+  pthread_t thread;
+  list_pt list;
+  long num_of_call;
+  int use_r;
+  long sum;
+} reader_t;
+
+static void *read_list( void *arg )
+{
+  reader_t *reader = (reader_t *)arg;
+  list_elm_pt element;
+  long i, sum = 0;
+  int size;
+
+  for(i = 0; i < reader->num_of_call; i++)
+  {
+    //short walks, so the cost of the call itself (and of the list_errno store) dominates
+    if(reader->use_r)
+    {
+      mylist_get_element_at_index_r(reader->list, (int)(i & 7), &element);
+      mylist_size_r(reader->list, &size);
+    }
+    else
+    {
+      element = mylist_get_element_at_index(reader->list, (int)(i & 7));
+      size = mylist_size(reader->list);
+    }
+    sum += *(int *)element + size;
+  }
+  reader->sum = sum;
+  return NULL;
+}
+
+static void check_status_api( void )
+{
+  list_pt list = NULL;
+  list_node_pt reference;
+  list_elm_pt element;
+  int i, n, value;
+
+  list_errno = LIST_ERRNO_UNTOUCHED;
+  CHECK(mylist_create_r(&list, &element_copy, &element_free, &element_compare, NULL) == LIST_NO_ERROR && list != NULL);
+  CHECK(mylist_size_r(list, &n) == LIST_NO_ERROR && n == 0);
+  CHECK(mylist_get_element_at_index_r(list, 0, &element) == LIST_EMPTY_ERROR && element == NULL);
+  CHECK(mylist_remove_at_index_r(list, 0) == LIST_EMPTY_ERROR);
+  for(i = 0; i < 10; i++) CHECK(mylist_insert_at_index_r(list, &i, i) == LIST_NO_ERROR);
+  CHECK(mylist_get_element_at_index_r(list, -5, &element) == LIST_NO_ERROR && *(int *)element == 0);
+  CHECK(mylist_get_element_at_index_r(list, 50, &element) == LIST_NO_ERROR && *(int *)element == 9);
+  CHECK(mylist_get_reference_at_index_r(list, 3, &reference) == LIST_NO_ERROR && *(int *)mylist_get_element_at_reference(reference) == 3);
+  value = 7;
+  CHECK(mylist_get_index_of_element_r(list, &value, &n) == LIST_NO_ERROR && n == 7);
+  CHECK(mylist_get_index_of_element_r(list, NULL, &n) == ELEMENT_INVALID_ERROR);
+  CHECK(mylist_free_at_index_r(list, 0) == LIST_NO_ERROR);
+  CHECK(mylist_size_r(list, &n) == LIST_NO_ERROR && n == 9);
+  CHECK(mylist_size_r(NULL, &n) == LIST_INVALID_ERROR);
+  CHECK(mylist_insert_at_index_r(NULL, &value, 0) == LIST_INVALID_ERROR);
+  CHECK(list_errno == LIST_ERRNO_UNTOUCHED);
+
+  //the wrappers report the same codes through list_errno
+  CHECK(mylist_get_index_of_element(list, NULL) == -1 && list_errno == ELEMENT_INVALID_ERROR);
+  CHECK(mylist_size(list) == 9 && list_errno == LIST_NO_ERROR);
+  list_errno = LIST_ERRNO_UNTOUCHED;
+  CHECK(mylist_free_r(&list) == LIST_NO_ERROR && list == NULL);
+  CHECK(mylist_free_r(&list) == LIST_INVALID_ERROR);
+  CHECK(list_errno == LIST_ERRNO_UNTOUCHED);
+}
+
+int main( int argc, char *argv[] )
+{
+  int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+  long num_of_call = (argc > 2) ? atol(argv[2]) : 10000000;
+  reader_t readers[64];
+  list_pt list;
+  int i, num_of_threads, use_r;
+  double start, seconds;
+
+  check_status_api();
+  printf("status API: results match the wrappers, list_errno untouched\n");
+
+  if(max_threads < 1) max_threads = 1;
+  if(max_threads > 64) max_threads = 64;
+  list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+  for(i = 0; i < 1024; i++) mylist_insert_at_index(list, &i, i);
+
+  printf("%8s %10s %16s %16s\n", "threads", "api", "ns/call/thread", "Mcalls/s total");
+  for(num_of_threads = 1; num_of_threads <= max_threads; num_of_threads *= 2)
+  {
+    for(use_r = 0; use_r < 2; use_r++)
+    {
+      start = now();
+      for(i = 0; i < num_of_threads; i++)
+      {
+        readers[i].list = list;
+        readers[i].num_of_call = num_of_call;
+        readers[i].use_r = use_r;
+        CHECK(pthread_create(&readers[i].thread, NULL, read_list, &readers[i]) == 0);
+      }
+      for(i = 0; i < num_of_threads; i++) pthread_join(readers[i].thread, NULL);
+      seconds = now() - start;
+      for(i = 1; i < num_of_threads; i++) CHECK(readers[i].sum == readers[0].sum);
+      //each iteration makes 2 calls
+      printf("%8d %10s %16.2f %16.1f\n", num_of_threads, use_r ? "_r" : "wrapper", seconds * 1e9 / (2.0 * num_of_call),
+             2.0 * num_of_call * num_of_threads / seconds / 1e6);
+    }
+  }
+  mylist_free(&list);
+  return 0;
+}
@@ -0,0 +1,218 @@
+//============================================================================
+// Name        : test_trace.cpp
+// Author      : Pham Hoang Chi
+// Version     :
+// Copyright   : Copyright from Pham Hoang Chi
+// Description : Test and benchmark of the LIST_TRACE hooks and mylisttrace
+//               Checks the events of single operations (op, index, nodes
+//               traversed, callbacks), compares the histogram percentiles
+//               with the exact ones of the recorded events, records from
+//               several threads at once and writes a Chrome trace. Then a
+//               get+insert+free loop is timed without hooks and with the
+//               collector attached. Build it once without -DLIST_TRACE to
+//               time the loop without any trace code.
+//
+//               Build: g++ -O2 -pthread -DLIST_TRACE test_trace.cpp mylisttrace.cpp mylist.cpp -o test_trace
+//               Usage: test_trace [number of operations] [chrome trace file]
+//============================================================================
+
+#include <string.h>
+#include <pthread.h>
+#include <vector>
+#include <algorithm>
+#include "mylisttrace.h"
+#include "test_common.h"
+using namespace std;
+
+#ifdef LIST_TRACE
+static vector<list_trace_event_t> events; // every 'after' event of the single-threaded checks
+static long num_of_before;
+
+static void hook_before( const list_trace_event_t *event, void *arg )
+{
+  num_of_before++;
+  CHECK(event->elapsed == 0);
+}
+
+static void hook_after( const list_trace_event_t *event, void *arg )
+{
+  events.push_back(*event);
+  mylisttrace_record((list_trace_collector_pt)arg, event);
+}
+
+static void check_events( list_trace_collector_pt collector )
+{
+  list_pt list, other;
+  vector<unsigned long long> elapsed;
+  unsigned long long exact, percentile;
+  double percentiles[] = { 50, 90, 99, 99.9, 100 };
+  int i, value = 42;
+
+  mylist_set_trace_hooks(&hook_before, &hook_after, collector);
+  list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+  CHECK(events.size() == 1 && events[0].op == LIST_OP_CREATE);
+  for(i = 0; i < 100; i++) mylist_insert_at_index(list, &i, i);
+  CHECK(events.back().op == LIST_OP_INSERT && events.back().index == 99);
+  CHECK(events.back().num_of_callback == 1 && events.back().num_of_node == 0);
+
+  //a walk from the nearer end
+  events.clear();
+  mylist_get_element_at_index(list, 10);
+  CHECK(events.size() == 1 && events[0].op == LIST_OP_GET_ELEMENT && events[0].num_of_node == 10);
+  mylist_get_element_at_index(list, 90);
+  CHECK(events.back().num_of_node == 9);
+  mylist_get_index_of_element(list, &value);
+  CHECK(events.back().op == LIST_OP_INDEX_OF && events.back().num_of_node == 43 && events.back().num_of_callback == 43);
+
+  //operations that call other list functions are one event
+  other = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+  mylist_insert_at_index(other, &value, 0);
+  events.clear();
+  mylist_union(list, other);
+  CHECK(events.size() == 1 && events[0].op == LIST_OP_UNION);
+  mylist_sort(list);
+  CHECK(events.back().op == LIST_OP_SORT && events.back().num_of_callback > 0);
+  CHECK(num_of_before == (long)mylisttrace_count(collector, -1));
+
+  //the histogram percentiles are at most 1/32 above the exact ones
+  mylisttrace_reset(collector);
+  events.clear();
+  for(i = 0; i < 20000; i++)
+  {
+    value = rand() % 1000;
+    mylist_insert_at_index(list, &value, rand() % 2000);
+    if(i % 3 == 0) mylist_free_at_index(list, rand() % 2000);
+  }
+  for(i = 0; i < (int)events.size(); i++)
+  {
+    if(events[i].op == LIST_OP_INSERT) elapsed.push_back(events[i].elapsed);
+  }
+  sort(elapsed.begin(), elapsed.end());
+  CHECK(mylisttrace_count(collector, LIST_OP_INSERT) == (long)elapsed.size());
+  CHECK(mylisttrace_count(collector, LIST_OP_FREE_AT) == 20000 / 3 + 1);
+  CHECK(mylisttrace_count(collector, -1) == (long)events.size());
+  for(i = 0; i < (int)(sizeof(percentiles) / sizeof(percentiles[0])); i++)
+  {
+    exact = elapsed[max(0, (int)(percentiles[i] / 100 * elapsed.size() + 0.5) - 1)];
+    percentile = mylisttrace_percentile(collector, LIST_OP_INSERT, percentiles[i]);
+    CHECK(percentile >= exact && percentile <= exact + exact / 32 + 1);
+  }
+  CHECK(mylisttrace_percentile(collector, LIST_OP_UNIQUE, 50) == 0);
+
+  mylist_set_trace_hooks(NULL, NULL, NULL);
+  mylist_free(&list);
+  mylist_free(&other);
+}
+
+static void *churn_list( void *arg )
+{
+  list_pt list;
+  list_elm_pt element;
+  int i;
+
+  //the _r calls leave the shared list_errno alone
+  CHECK(mylist_create_r(&list, &element_copy, &element_free, &element_compare, NULL) == LIST_NO_ERROR);
+  for(i = 0; i < 10000; i++)
+  {
+    mylist_insert_at_index_r(list, &i, 0);
+    mylist_get_element_at_index_r(list, i, &element);
+  }
+  mylist_free_r(&list);
+  return NULL;
+}
+
+static void check_threads( list_trace_collector_pt collector )
+{
+  pthread_t threads[4];
+  int i;
+
+  //events are recorded concurrently: none is lost
+  mylisttrace_reset(collector);
+  mylisttrace_attach(collector);
+  for(i = 0; i < 4; i++) CHECK(pthread_create(&threads[i], NULL, churn_list, NULL) == 0);
+  //the table is a snapshot taken under the lock while the threads record
+  mylisttrace_print(collector);
+  CHECK(list_errno == LIST_NO_ERROR);
+  for(i = 0; i < 4; i++) pthread_join(threads[i], NULL);
+  mylisttrace_detach();
+  CHECK(mylisttrace_count(collector, LIST_OP_INSERT) == 4 * 10000);
+  CHECK(mylisttrace_count(collector, LIST_OP_GET_ELEMENT) == 4 * 10000);
+  CHECK(mylisttrace_count(collector, -1) == 4 * (2 * 10000 + 2));
+}
+
+static void check_chrome( list_trace_collector_pt collector, const char *file_name )
+{
+  FILE *fp = (file_name != NULL) ? fopen(file_name, "w+") : tmpfile();
+  char line[512];
+  int num_of_event, num_of_line = 0;
+
+  CHECK(fp != NULL);
+  num_of_event = mylisttrace_dump_chrome(collector, fp);
+  CHECK(num_of_event == 1000); // the ring keeps the last 1000 of the 80008 events
+  rewind(fp);
+  CHECK(fgets(line, sizeof(line), fp) != NULL && strcmp(line, "{\"traceEvents\":[\n") == 0);
+  while(fgets(line, sizeof(line), fp) != NULL)
+  {
+    if(strstr(line, "\"ph\":\"X\"") != NULL) num_of_line++;
+  }
+  CHECK(num_of_line == num_of_event);
+  fclose(fp);
+  CHECK(mylisttrace_dump_chrome(collector, NULL) == -1 && list_errno == LIST_INVALID_ERROR);
+  CHECK(mylisttrace_dump_chrome(NULL, stdout) == -1 && list_errno == LIST_INVALID_ERROR);
+}
+#endif
+
+static double run_loop( long num_of_op )
+{
+  list_pt list = mylist_create(&element_copy, &element_free, &element_compare, NULL);
+  long i, sum = 0;
+  int value;
+  double start;
+
+  for(value = 0; value < 64; value++) mylist_insert_at_index(list, &value, value);
+  srand(1);
+  start = now();
+  for(i = 0; i < num_of_op; i++)
+  {
+    sum += *(int *)mylist_get_element_at_index(list, rand() & 63);
+    value = (int)i;
+    mylist_insert_at_index(list, &value, 0);
+    mylist_free_at_index(list, 0);
+  }
+  start = now() - start;
+  mylist_free(&list);
+  if(sum < 0) abort();
+  return start;
+}
+
+int main( int argc, char *argv[] )
+{
+  long num_of_op = (argc > 1) ? atol(argv[1]) : 5000000;
+  double seconds;
+
+#ifdef LIST_TRACE
+  list_trace_collector_pt collector = mylisttrace_create(1000);
+
+  CHECK(collector != NULL);
+  check_events(collector);
+  check_threads(collector);
+  check_chrome(collector, (argc > 2) ? argv[2] : NULL);
+  printf("trace events, percentiles and chrome dump checked\n");
+  mylisttrace_reset(collector);
+#endif
+
+  printf("ns per get+insert+free on a 64 element list\n");
+  seconds = run_loop(num_of_op);
+#ifdef LIST_TRACE
+  printf("%-24s %8.1f\n", "hooks not set", seconds / num_of_op * 1e9);
+  mylisttrace_attach(collector);
+  seconds = run_loop(num_of_op);
+  mylisttrace_detach();
+  printf("%-24s %8.1f\n", "collector attached", seconds / num_of_op * 1e9);
+  mylisttrace_print(collector);
+  mylisttrace_free(&collector);
+#else
+  printf("%-24s %8.1f\n", "without LIST_TRACE", seconds / num_of_op * 1e9);
+#endif
+  return 0;
+}